@@ -13,3 +13,4 @@ BigInt multiply(BigInt const& x, BigInt const& y);
 // Division Algorithms
 BigInt knuth(BigInt const& x, uint64_t y, bool remainder);
 BigInt knuth(BigInt const& x, BigInt const& y, bool remainder);
+BigInt newton(BigInt const& x, BigInt const& y, bool remainder);
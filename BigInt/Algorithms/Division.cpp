@@ -3,6 +3,57 @@
 
 #include <stdexcept>
 
+namespace {
+size_t constexpr newton_threshold = 64;
+
+BigInt reciprocal(BigInt const& Y, size_t p)
+{
+    // Approximate 2^(2p) / Y for Y of exactly p bits using Newton's iteration V <- 2V - YV^2 / 2^(2p),
+    // doubling the precision at each level of recursion
+    if (p <= 32 * newton_threshold)
+        return knuth(BigInt { 1 } << static_cast<int>(2 * p), Y, false);
+
+    auto const h = p / 2 + 2;
+    auto const V = reciprocal(Y >> static_cast<int>(p - h), h) << static_cast<int>(p - h);
+
+    return (V << 1) - ((Y * V * V) >> static_cast<int>(2 * p));
+}
+}
+
+BigInt newton(BigInt const& x, BigInt const& y, bool remainder)
+{
+    // Division by multiplication with a precomputed reciprocal, asymptotically as fast as multiply().
+    // The quotient estimate is off by at most a few units and is corrected so that 0 <= r < |y|.
+    auto const X = x.abs();
+    auto const Y = y.abs();
+
+    if (X < Y)
+        return remainder ? X : BigInt {};
+
+    auto const s = X.size();
+    auto const t = Y.size();
+    auto const p = s - t + 33;
+
+    // With Y' the top p bits of Y (or Y padded to p bits), 2^(2p) / Y' ~ 2^(p + t) / Y
+    auto const Yp = p >= t ? Y << static_cast<int>(p - t) : Y >> static_cast<int>(t - p);
+    auto const inverse = reciprocal(Yp, p);
+
+    auto q = (X * inverse) >> static_cast<int>(p + t);
+    auto r = X - q * Y;
+
+    while (r.is_negative()) {
+        q -= 1;
+        r += Y;
+    }
+
+    while (r >= Y) {
+        q += 1;
+        r -= Y;
+    }
+
+    return remainder ? r : q;
+}
+
 BigInt knuth(BigInt const& x, BigInt const& y, bool remainder)
 {
     // Algorithm D, The Art of Computer Programming Vol. 2 Seminumerical Algorithms 3rd ed. pg. 272
@@ -28,6 +79,10 @@ BigInt knuth(BigInt const& x, BigInt const& y, bool remainder)
         return { 1 };
     }
 
+    // Long quotients by long divisors are cheaper through a Newton reciprocal
+    if (y.groups() > newton_threshold && x.groups() - y.groups() > newton_threshold)
+        return newton(x, y, remainder);
+
     auto Q = std::deque<uint32_t>(x.groups());
     auto S = __builtin_clz(y.get_groups().back());
     auto U = (x << S).get_groups();
@@ -91,6 +146,13 @@ BigInt knuth(BigInt const& x, BigInt const& y, bool remainder)
 BigInt knuth(BigInt const& x, uint64_t y, bool remainder)
 {
     // Degenerate case of Algorithm D
+    if (y == 0)
+        throw new std::runtime_error("[BigInt] Div by 0.");
+
+    // Divisors wider than a single group need the general algorithm
+    if (y >> 32)
+        return knuth(x, BigInt { std::deque<uint32_t> { static_cast<uint32_t>(y), static_cast<uint32_t>(y >> 32) } }, remainder);
+
     auto Q = std::deque<uint32_t>(x.groups());
     auto k = uint64_t {};
 
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <deque>
+#include <span>
+#include <vector>
 
 template <typename T>
 [[gnu::flatten]] BigInt naive_muladd(BigInt const& x, BigInt const& mul, BigInt const* add, T&& operation)
@@ -49,9 +51,128 @@ template <typename T>
                         });
 }
 
+namespace {
+using Groups = std::vector<uint32_t>;
+using View = std::span<uint32_t const>;
+
+void add_at(Groups& z, View x, size_t offset)
+{
+    // z += x * 2^(32 * offset), z must be large enough to hold the result
+    while (!x.empty() && x.back() == 0)
+        x = x.first(x.size() - 1);
+
+    auto carry = uint64_t {};
+
+    for (auto i = 0uz; i < x.size() || carry; i++) {
+        carry += static_cast<uint64_t>(z[offset + i]) + (i < x.size() ? x[i] : 0);
+        z[offset + i] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+}
+
+void sub_from(Groups& z, View x)
+{
+    // z -= x, requires z >= x
+    auto borrow = int64_t {};
+
+    for (auto i = 0uz; i < x.size() || borrow; i++) {
+        borrow += static_cast<int64_t>(z[i]) - (i < x.size() ? x[i] : 0);
+        z[i] = static_cast<uint32_t>(borrow);
+        borrow >>= 32;
+    }
+}
+
+Groups add(View x, View y)
+{
+    if (x.size() < y.size())
+        std::swap(x, y);
+
+    auto z = Groups(x.size() + 1);
+    std::copy(x.begin(), x.end(), z.begin());
+    add_at(z, y, 0);
+
+    return z;
+}
+
+void basecase(Groups& z, View x, View y, size_t offset)
+{
+    // Schoolbook product accumulated into z at the given offset
+    for (auto i = 0uz; i < x.size(); i++) {
+        auto carry = uint64_t {};
+
+        for (auto j = 0uz; j < y.size(); j++) {
+            carry += static_cast<uint64_t>(x[i]) * y[j] + z[offset + i + j];
+            z[offset + i + j] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+
+        for (auto k = offset + i + y.size(); carry; k++) {
+            carry += z[k];
+            z[k] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+}
+
+size_t constexpr karatsuba_threshold = 48;
+
+Groups karatsuba(View x, View y)
+{
+    /**
+     * Karatsuba multiplication: with x = x1 B + x0 and y = y1 B + y0,
+     * xy = x1y1 B^2 + ((x0 + x1)(y0 + y1) - x0y0 - x1y1) B + x0y0
+     */
+    if (x.size() < y.size())
+        std::swap(x, y);
+
+    auto z = Groups(x.size() + y.size() + 1);
+
+    if (y.size() < karatsuba_threshold) {
+        basecase(z, x, y, 0);
+        return z;
+    }
+
+    if (x.size() >= 2 * y.size()) {
+        // Unbalanced operands, multiply y-sized slices of x
+        for (auto i = 0uz; i < x.size(); i += y.size()) {
+            auto const slice = x.subspan(i, std::min(y.size(), x.size() - i));
+            add_at(z, karatsuba(slice, y), i);
+        }
+
+        return z;
+    }
+
+    auto const h = x.size() / 2;
+
+    auto const x0 = x.first(h), x1 = x.subspan(h);
+    auto const y0 = y.first(h), y1 = y.subspan(h);
+
+    auto const z0 = karatsuba(x0, y0);
+    auto const z2 = karatsuba(x1, y1);
+    auto z1 = karatsuba(add(x0, x1), add(y0, y1));
+
+    sub_from(z1, z0);
+    sub_from(z1, z2);
+
+    add_at(z, z0, 0);
+    add_at(z, z1, h);
+    add_at(z, z2, 2 * h);
+
+    return z;
+}
+}
+
 [[gnu::flatten]] BigInt multiply(BigInt const& x, BigInt const& y)
 {
-    // TODO: Implement Karatsuba and Toom-k algorithms for asymptotically faster results
+    if (std::min(x.groups(), y.groups()) < karatsuba_threshold)
+        return naive_muladd(x, y, nullptr);
+
+    auto const xg = Groups(x.get_groups().begin(), x.get_groups().end());
+    auto const yg = Groups(y.get_groups().begin(), y.get_groups().end());
+    auto const z = karatsuba(xg, yg);
 
-    return naive_muladd(x, y, nullptr);
+    auto result = std::deque<uint32_t>(z.begin(), z.end());
+    emsmallen(result);
+
+    return { result };
 }
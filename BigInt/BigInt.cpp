@@ -2,9 +2,11 @@
 #include <BigInt/BigInt.h>
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <random>
 #include <stdexcept>
+#include <vector>
 
 BigInt::BigInt()
     : m_groups({})
@@ -102,19 +104,30 @@ void BigInt::random(int bits)
 {
     // Generate a random big integer
     // Utilizes a Mersenne twister -> determinstic, not suitable for actual cryptography
-    auto static rd = std::random_device {};
-    auto static e2 = std::mt19937_64 { rd() };
-    auto static dist = std::uniform_int_distribution<uint64_t> { 0, 1ull << 32 };
+    // The engine is thread_local so that concurrent callers (e.g. ECM workers) do not race
+    auto static thread_local rd = std::random_device {};
+    auto static thread_local e2 = std::mt19937_64 { rd() };
+    auto static thread_local dist = std::uniform_int_distribution<uint32_t> {};
     m_groups.clear();
+    m_negative = false;
 
     for (auto i = 0; i < bits / 32; i++)
-        m_groups.push_back(static_cast<uint32_t>(dist(e2)));
+        m_groups.push_back(dist(e2));
 
-    m_groups.push_back(static_cast<uint32_t>(dist(e2)) >> (32 - (bits % 32)));
+    if (bits % 32)
+        m_groups.push_back(dist(e2) >> (32 - (bits % 32)));
+
+    if (m_groups.empty())
+        m_groups.push_back(0);
+
+    emsmallen();
 }
 
 size_t BigInt::trailing_zeros() const
 {
+    if (is_zero())
+        return 0;
+
     auto i = 0uz;
 
     for (; i < m_groups.size(); i++)
@@ -127,6 +140,9 @@ size_t BigInt::trailing_zeros() const
 size_t BigInt::size() const
 {
     // Get size of number in bits
+    if (is_zero())
+        return 0;
+
     return ((groups() - 1) * 32) + (32 - __builtin_clz(m_groups.back()));
 }
 
@@ -137,6 +153,9 @@ bool BigInt::is_power_of_two() const
 
 bool BigInt::bit_at(size_t n) const
 {
+    if (n / 32 >= m_groups.size())
+        return false;
+
     auto const& group = m_groups[n / 32];
 
     return group & (1ul << (n % 32));
@@ -169,7 +188,7 @@ void BigInt::embiggen(size_t size)
         m_groups.push_back(0);
 }
 
-inline void emsmallen(std::deque<uint32_t>& groups)
+void emsmallen(std::deque<uint32_t>& groups)
 {
     // Remove all leading digit groups valued at 0, except for the last one
     if (groups.size() == 0) {
@@ -182,94 +201,95 @@ inline void emsmallen(std::deque<uint32_t>& groups)
         groups.pop_back();
 }
 
-inline void BigInt::emsmallen() { ::emsmallen(m_groups); }
-
-BigInt& BigInt::operator-=(BigInt const& rhs)
+void BigInt::emsmallen()
 {
-    if (rhs.m_negative)
-        return *this += -rhs;
-
-    auto it = m_groups.begin();
-
-    auto lit = std::as_const(m_groups).begin();
-    auto lend = std::as_const(m_groups).end();
+    ::emsmallen(m_groups);
 
-    auto rit = rhs.m_groups.begin();
-    auto rend = rhs.m_groups.end();
+    // There is no negative zero
+    if (is_zero())
+        m_negative = false;
+}
 
-    if (*this < rhs) {
-        std::swap(lit, rit);
-        std::swap(lend, rend);
+int compare_magnitude(std::deque<uint32_t> const& lhs, std::deque<uint32_t> const& rhs)
+{
+    // Compare |lhs| and |rhs|, both groups are expected to be emsmallened
+    if (lhs.size() != rhs.size())
+        return lhs.size() < rhs.size() ? -1 : 1;
 
-        embiggen(rhs);
-        rend = std::as_const(m_groups).end();
+    for (auto i = lhs.size(); i-- > 0;) {
+        if (lhs[i] == rhs[i])
+            continue;
 
-        m_negative = true;
+        return lhs[i] < rhs[i] ? -1 : 1;
     }
 
-    auto borrow = int64_t {};
+    return 0;
+}
+
+static void add_magnitude(std::deque<uint32_t>& lhs, std::deque<uint32_t> const& rhs)
+{
+    // Compute |lhs| + |rhs| in place
+    if (lhs.size() < rhs.size())
+        lhs.resize(rhs.size());
 
-    for (; lit != lend; lit++, it++) {
-        auto difference = static_cast<int64_t>(*lit) + borrow;
+    auto sum = uint64_t {};
+    for (auto i = 0uz; i < lhs.size(); i++) {
+        sum += lhs[i];
 
-        if (rit != rend) {
-            difference -= static_cast<int64_t>(*rit);
-            rit++;
-        }
+        if (i < rhs.size())
+            sum += rhs[i];
 
-        *it = static_cast<uint32_t>(difference);
-        borrow = difference >> 32;
+        lhs[i] = static_cast<uint32_t>(sum);
+        sum >>= 32;
     }
 
-    emsmallen();
-
-    return *this;
+    if (sum)
+        lhs.push_back(static_cast<uint32_t>(sum));
 }
 
-BigInt& BigInt::operator+=(BigInt const& rhs)
+static void sub_magnitude(std::deque<uint32_t>& lhs, std::deque<uint32_t> const& rhs)
 {
-    if (rhs.m_negative)
-        return *this -= rhs;
+    // Compute |lhs| - |rhs| in place, requires |lhs| >= |rhs|
+    auto borrow = int64_t {};
+    for (auto i = 0uz; i < lhs.size(); i++) {
+        auto difference = static_cast<int64_t>(lhs[i]) + borrow;
 
-    if (m_negative) {
-        auto temp = *this;
-        *this = rhs;
+        if (i < rhs.size())
+            difference -= static_cast<int64_t>(rhs[i]);
 
-        return *this -= -temp;
+        lhs[i] = static_cast<uint32_t>(difference);
+        borrow = difference >> 32;
     }
 
-    embiggen(rhs);
-
-    auto lit = m_groups.begin();
-    auto const& lend = m_groups.end();
-
-    auto rit = std::as_const(rhs.m_groups).begin();
-    auto const& rend = rhs.m_groups.end();
+    emsmallen(lhs);
+}
 
-    auto sum = uint64_t {};
-    while (lit != lend || rit != rend) {
-        if (lit != lend) {
-            sum += *lit;
-            lit++;
-        }
+BigInt& BigInt::add(BigInt const& rhs, bool negate)
+{
+    // Signed addition of (-1)^negate * rhs
+    auto const rhs_negative = rhs.m_negative ^ negate;
 
-        if (rit != rend) {
-            sum += *rit;
-            rit++;
-        }
+    if (m_negative == rhs_negative) {
+        add_magnitude(m_groups, rhs.m_groups);
+    } else if (compare_magnitude(m_groups, rhs.m_groups) >= 0) {
+        sub_magnitude(m_groups, rhs.m_groups);
+    } else {
+        auto groups = rhs.m_groups;
+        sub_magnitude(groups, m_groups);
 
-        *std::prev(lit) = static_cast<uint32_t>(sum);
-        sum >>= 32;
+        m_groups = std::move(groups);
+        m_negative = rhs_negative;
     }
 
-    if (sum)
-        m_groups.push_back(1);
-
     emsmallen();
 
     return *this;
 }
 
+BigInt& BigInt::operator-=(BigInt const& rhs) { return add(rhs, true); }
+
+BigInt& BigInt::operator+=(BigInt const& rhs) { return add(rhs, false); }
+
 BigInt& BigInt::operator*=(BigInt const& rhs)
 {
     // Perform multiplication
@@ -294,7 +314,7 @@ BigInt& BigInt::operator*=(int rhs)
 
 BigInt& BigInt::operator*=(uint64_t rhs)
 {
-    m_groups = multiply(*this, rhs).m_groups;
+    m_groups = multiply(*this, BigInt { std::deque<uint32_t> { static_cast<uint32_t>(rhs), static_cast<uint32_t>(rhs >> 32) } }).m_groups;
 
     emsmallen();
 
@@ -345,11 +365,12 @@ BigInt& BigInt::operator%=(BigInt const& rhs)
 
     m_groups = knuth(*this, rhs, true).m_groups;
 
-    while (m_negative)
-        *this += rhs;
-
     emsmallen();
 
+    // Remainder is always taken to be in [0, rhs)
+    if (m_negative)
+        *this += rhs;
+
     return *this;
 }
 
@@ -365,11 +386,11 @@ BigInt& BigInt::operator%=(uint64_t rhs)
 {
     m_groups = knuth(*this, rhs, true).m_groups;
 
-    if (m_negative)
-        *this += rhs;
-
     emsmallen();
 
+    if (m_negative)
+        *this += BigInt { std::deque<uint32_t> { static_cast<uint32_t>(rhs), static_cast<uint32_t>(rhs >> 32) } };
+
     return *this;
 }
 
@@ -379,7 +400,7 @@ BigInt BigInt::operator%(uint64_t rhs) const { return BigInt { *this } %= rhs; }
 
 BigInt& BigInt::operator<<=(int rhs)
 {
-    if (rhs == 0)
+    if (rhs == 0 || is_zero())
         return *this;
 
     if (rhs < 0)
@@ -392,13 +413,14 @@ BigInt& BigInt::operator<<=(int rhs)
 
     auto s = rhs % 32;
 
-    if (__builtin_clz(m_groups.back()) < s)
+    if (s) {
         m_groups.push_back(0);
 
-    for (auto i = m_groups.size() - 1; i > 0; i--)
-        m_groups[i] = (m_groups[i] << s) | (m_groups[i - 1] >> (32 - s));
+        for (auto i = m_groups.size() - 1; i > 0; i--)
+            m_groups[i] = (m_groups[i] << s) | (m_groups[i - 1] >> (32 - s));
 
-    m_groups[0] <<= s;
+        m_groups[0] <<= s;
+    }
 
     emsmallen();
 
@@ -415,28 +437,25 @@ BigInt& BigInt::operator>>=(int rhs)
 
     if (static_cast<size_t>(rhs) >= size()) {
         m_groups.clear();
-        m_groups[0] = 0;
+        m_groups.push_back(0);
+        m_negative = false;
 
         return *this;
     }
 
     auto groups = static_cast<size_t>(rhs / 32);
 
-    if (groups > m_groups.size()) {
-        m_groups.clear();
-        m_groups.push_back(0);
-
-        return *this;
-    }
-
     for (auto i = 0uz; i < groups; i++)
         m_groups.pop_front();
 
     auto s = rhs % 32;
-    for (auto i = 0uz; i < m_groups.size() - 1; i++)
-        m_groups[i] = (m_groups[i] >> s) | static_cast<uint64_t>(m_groups[i + 1] << (32 - s));
 
-    m_groups[m_groups.size() - 1] >>= s;
+    if (s) {
+        for (auto i = 0uz; i < m_groups.size() - 1; i++)
+            m_groups[i] = (m_groups[i] >> s) | (m_groups[i + 1] << (32 - s));
+
+        m_groups[m_groups.size() - 1] >>= s;
+    }
 
     emsmallen();
 
@@ -490,46 +509,19 @@ BigInt BigInt::operator-() const
 
 bool BigInt::operator==(BigInt const& rhs) const
 {
-    if (m_negative != rhs.m_negative
-        || m_groups.size() != rhs.m_groups.size()
-        || size() != rhs.size())
-        return false;
-
-    for (auto lit = m_groups.begin(), rit = rhs.m_groups.begin(); lit != m_groups.end(); lit++, rit++)
-        if (*lit != *rit)
-            return false;
-
-    return true;
+    return m_negative == rhs.m_negative && m_groups == rhs.m_groups;
 }
 
 bool BigInt::operator!=(BigInt const& rhs) const { return !(*this == rhs); }
 
 int BigInt::operator<=>(BigInt const& rhs) const
 {
-    if (*this == rhs)
-        return 0;
-
-    if (m_negative && !rhs.m_negative)
-        return 1;
-
-    if (!m_negative && rhs.m_negative)
-        return -1;
+    if (m_negative != rhs.m_negative)
+        return m_negative ? -1 : 1;
 
-    if (m_groups.size() > rhs.m_groups.size() || size() > rhs.size())
-        return (m_negative && rhs.m_negative) ? -1 : 1;
+    auto const order = compare_magnitude(m_groups, rhs.m_groups);
 
-    if (m_groups.size() < rhs.m_groups.size() || size() < rhs.size())
-        return (m_negative && rhs.m_negative) ? 1 : -1;
-
-    for (auto lit = m_groups.begin(), rit = rhs.m_groups.begin(); lit != m_groups.end(); lit++, rit++) {
-        if (*lit == *rit)
-            continue;
-
-        if (*lit < *rit)
-            return (m_negative && rhs.m_negative) ? 1 : -1;
-    }
-
-    return 0;
+    return m_negative ? -order : order;
 }
 
 bool BigInt::operator<=(BigInt const& rhs) const { return (*this <=> rhs) <= 0; }
@@ -551,46 +543,36 @@ std::ostream& operator<<(std::ostream& stream, BigInt const& number)
     if (size == 1)
         return stream << group[0];
 
-    auto static muladd10 = [&](std::deque<uint32_t> x, uint64_t mul, uint64_t add) -> std::deque<uint32_t> {
-        auto z = std::deque<uint32_t>(4 * (number.groups() + 1));
-        auto static constexpr base = BigInt::base;
-
-        for (auto i = 0uz; i < x.size(); i++) {
-            auto product = static_cast<uint64_t>(x[i]) * mul + z[i];
+    // Peel off base 10^9 digits by short division, least significant first
+    auto static constexpr base = BigInt::base;
+    auto quotient = std::vector<uint32_t>(group.rbegin(), group.rend());
+    auto digits = std::vector<uint32_t> {};
 
-            z[i] = product % base;
-            z[i + 1] = product / base;
-        }
+    while (!quotient.empty()) {
+        auto remainder = uint64_t {};
 
-        auto carry = add;
-        for (auto i = 0uz; i < z.size(); i++) {
-            auto sum = static_cast<uint64_t>(z[i]) + carry;
+        for (auto& g : quotient) {
+            auto const current = (remainder << 32) | g;
 
-            z[i] = sum % base;
-            carry = sum / base;
+            g = static_cast<uint32_t>(current / base);
+            remainder = current % base;
         }
 
-        return z;
-    };
-
-    auto z = std::deque<uint32_t> {};
+        digits.push_back(static_cast<uint32_t>(remainder));
 
-    for (auto git = number.m_groups.rbegin(); git != number.m_groups.rend(); git++)
-        z = muladd10(z, 1ull << 32, *git);
+        quotient.erase(quotient.begin(), std::find_if(quotient.begin(), quotient.end(), [](uint32_t g) { return g != 0; }));
+    }
 
-    auto i = z.size() - 1;
+    auto it = digits.rbegin();
 
-    while (z[i] == 0)
-        if (__builtin_sub_overflow_p(i - 1, 1, i))
-            return stream << 0;
+    stream << *it++;
 
-    auto it = z.rbegin() + (z.size() - i - 1);
+    auto const fill = stream.fill('0');
 
-    stream << *it++;
+    for (; it != digits.rend(); it++)
+        stream << std::setw(BigInt::digits) << *it;
 
-    for (; it != z.rend(); it++)
-        if (*it)
-            stream << *it;
+    stream.fill(fill);
 
     return stream;
 }
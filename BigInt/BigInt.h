@@ -8,6 +8,7 @@
 #include <BigInt/Algorithms/Algorithms.h>
 
 void emsmallen(std::deque<uint32_t>& groups);
+int compare_magnitude(std::deque<uint32_t> const& lhs, std::deque<uint32_t> const& rhs);
 
 template <typename T>
 concept Numeric = std::convertible_to<T, std::size_t>;
@@ -53,6 +54,8 @@ private:
     void embiggen(size_t size);
     void emsmallen();
 
+    BigInt& add(BigInt const& rhs, bool negate);
+
     // TODO: Make this work for radices not 10
     size_t static constexpr radix = 10;
     size_t static constexpr digits = get_max_digits<uint32_t, radix>();
@@ -115,6 +118,17 @@ public:
 
     inline std::deque<uint32_t> const& get_groups() const { return m_groups; }
     inline bool is_negative() const { return m_negative; }
+    inline bool is_zero() const { return m_groups.size() == 1 && m_groups[0] == 0; }
+    inline uint64_t to_uint64() const
+    {
+        // Least significant 64 bits of |this|
+        auto value = static_cast<uint64_t>(m_groups[0]);
+
+        if (m_groups.size() > 1)
+            value |= static_cast<uint64_t>(m_groups[1]) << 32;
+
+        return value;
+    }
     size_t trailing_zeros() const;
     bool bit_at(size_t n) const;
     BigInt abs() const;
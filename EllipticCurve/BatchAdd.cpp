@@ -0,0 +1,123 @@
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <stdexcept>
+
+void BatchAdd(Curve const& curve, std::span<Coordinate> acc, std::span<Coordinate const> addend)
+{
+    /**
+     * Montgomery's simultaneous inversion
+     * Every lane needs 1 / (x2 - x1), or 1 / 2y1 when doubling. The running products of the denominators
+     * are inverted once and unwound from the end, so that n additions cost one inversion and about 3n
+     * multiplications. Lanes with infinity or P + (-P) are settled up front and take no part in the batch.
+     */
+    enum class Lane : uint8_t {
+        Settled,
+        Add,
+        Double,
+    };
+
+    if (acc.size() != addend.size())
+        throw new std::runtime_error("[BatchAdd] Batches differ in length");
+
+    auto const& F = curve.get_arithmetic();
+    auto const n = acc.size();
+
+    auto lanes = std::vector<Lane>(n, Lane::Settled);
+    auto prefix = std::vector<BigInt>(n);
+    auto product = F.one();
+
+    // prefix[i] is the product of the denominators of lanes 0..i, settled lanes pass it on unchanged
+    for (auto i = 0uz; i < n; i++) {
+        auto& P = acc[i];
+        auto const& Q = addend[i];
+
+        if (Q.m_w == 0) {
+            // P + infinity = P
+        } else if (P.m_w == 0) {
+            P = Q;
+        } else if (P.m_x != Q.m_x) {
+            lanes[i] = Lane::Add;
+            product = F.mul(product, F.sub(Q.m_x, P.m_x));
+        } else if (P.m_y == Q.m_y && !P.m_y.is_zero()) {
+            lanes[i] = Lane::Double;
+            product = F.mul(product, F.add(P.m_y, P.m_y));
+        } else {
+            P = Coordinate { 0, 0, 0 };
+        }
+
+        prefix[i] = product;
+    }
+
+    auto inverse = F.inv(product);
+
+    for (auto i = n; i-- > 0;) {
+        if (lanes[i] == Lane::Settled)
+            continue;
+
+        auto& P = acc[i];
+        auto const& Q = addend[i];
+
+        auto const denominator = lanes[i] == Lane::Add ? F.sub(Q.m_x, P.m_x) : F.add(P.m_y, P.m_y);
+
+        // inverse is 1 / prefix[i], so dropping the earlier denominators leaves 1 / denominator
+        auto lambda = i ? F.mul(inverse, prefix[i - 1]) : inverse;
+        inverse = F.mul(inverse, denominator);
+
+        if (lanes[i] == Lane::Add) {
+            lambda = F.mul(lambda, F.sub(Q.m_y, P.m_y));
+        } else {
+            auto const xx = F.sqr(P.m_x);
+            lambda = F.mul(lambda, F.add(F.add(F.add(xx, xx), xx), curve.get_a_field()));
+        }
+
+        auto const x = F.sub(F.sub(F.sqr(lambda), P.m_x), Q.m_x);
+
+        P.m_y = F.sub(F.mul(lambda, F.sub(P.m_x, x)), P.m_y);
+        P.m_x = x;
+    }
+}
+
+std::vector<Point> BatchAdd(std::span<Point const> lhs, std::span<Point const> rhs)
+{
+    if (lhs.size() != rhs.size())
+        throw new std::runtime_error("[BatchAdd] Batches differ in length");
+
+    if (lhs.empty())
+        return {};
+
+    auto const& curve = lhs[0].get_curve();
+    auto const& F = curve->get_arithmetic();
+
+    auto const convert = [&F](Point const& point) {
+        if (point.get_w() == 0)
+            return Coordinate { 0, 0, 0 };
+
+        return Coordinate { F.to(point.get_x()), F.to(point.get_y()) };
+    };
+
+    auto acc = std::vector<Coordinate>(lhs.size());
+    auto addend = std::vector<Coordinate>(rhs.size());
+
+    for (auto i = 0uz; i < lhs.size(); i++) {
+        assert((lhs[i] |= lhs[0]) && (rhs[i] |= lhs[0]));
+
+        acc[i] = convert(lhs[i]);
+        addend[i] = convert(rhs[i]);
+    }
+
+    BatchAdd(*curve, acc, addend);
+
+    auto result = std::vector<Point> {};
+    result.reserve(acc.size());
+
+    for (auto const& coordinate : acc) {
+        if (coordinate.m_w == 0) {
+            result.push_back(Point::make_point_at_infinity(curve));
+            continue;
+        }
+
+        result.push_back(Point::make_unchecked(F.from(coordinate.m_x), F.from(coordinate.m_y), curve));
+    }
+
+    return result;
+}
@@ -0,0 +1,71 @@
+#include <EllipticCurve/Curves.h>
+
+namespace {
+NamedCurve Make(std::string name, BigInt a, BigInt b, BigInt field, BigInt x, BigInt y, BigInt order, BigInt cofactor)
+{
+    auto curve = Curve::make(std::move(a), std::move(b), std::move(field));
+    auto generator = Point { std::move(x), std::move(y), curve };
+
+    return NamedCurve { std::move(name), std::move(curve), std::move(generator), std::move(order), std::move(cofactor) };
+}
+}
+
+NamedCurve const& Secp256k1()
+{
+    static auto const curve = Make(
+        "secp256k1",
+        0,
+        7,
+        BigInt { "115792089237316195423570985008687907853269984665640564039457584007908834671663" },
+        BigInt { "55066263022277343669578718895168534326250603453777594175500187360389116729240" },
+        BigInt { "32670510020758816978083085130507043184471273380659243275938904335757337482424" },
+        BigInt { "115792089237316195423570985008687907852837564279074904382605163141518161494337" },
+        1);
+
+    return curve;
+}
+
+NamedCurve const& P256()
+{
+    static auto const curve = Make(
+        "P-256",
+        BigInt { "115792089210356248762697446949407573530086143415290314195533631308867097853948" },
+        BigInt { "41058363725152142129326129780047268409114441015993725554835256314039467401291" },
+        BigInt { "115792089210356248762697446949407573530086143415290314195533631308867097853951" },
+        BigInt { "48439561293906451759052585252797914202762949526041747995844080717082404635286" },
+        BigInt { "36134250956749795798585127919587881956611106672985015071877198253568414405109" },
+        BigInt { "115792089210356248762697446949407573529996955224135760342422259061068512044369" },
+        1);
+
+    return curve;
+}
+
+NamedCurve const& P384()
+{
+    static auto const curve = Make(
+        "P-384",
+        BigInt { "39402006196394479212279040100143613805079739270465446667948293404245721771496870329047266088258938001861606973112316" },
+        BigInt { "27580193559959705877849011840389048093056905856361568521428707301988689241309860865136260764883745107765439761230575" },
+        BigInt { "39402006196394479212279040100143613805079739270465446667948293404245721771496870329047266088258938001861606973112319" },
+        BigInt { "26247035095799689268623156744566981891852923491109213387815615900925518854738050089022388053975719786650872476732087" },
+        BigInt { "8325710961489029985546751289520108179287853048861315594709205902480503199884419224438643760392947333078086511627871" },
+        BigInt { "39402006196394479212279040100143613805079739270465446667946905279627659399113263569398956308152294913554433653942643" },
+        1);
+
+    return curve;
+}
+
+NamedCurve const& Wei25519()
+{
+    static auto const curve = Make(
+        "Wei25519",
+        BigInt { "19298681539552699237261830834781317975544997444273427339909597334573241639236" },
+        BigInt { "55751746669818908907645289078257140818241103727901012315294400837956729358436" },
+        BigInt { "57896044618658097711785492504343953926634992332820282019728792003956564819949" },
+        BigInt { "19298681539552699237261830834781317975544997444273427339909597334652188435546" },
+        BigInt { "14781619447589544791020593568409986887264606134616475288964881837755586237401" },
+        BigInt { "7237005577332262213973186563042994240857116359379907606001950938285454250989" },
+        8);
+
+    return curve;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <string>
+
+struct NamedCurve {
+    // Standard curve with a generator of prime order n, the group order being n * h
+    std::string m_name;
+    CurveContext m_curve;
+    Point m_generator;
+    BigInt m_order;
+    BigInt m_cofactor;
+};
+
+// Built once and shared, the curve fields select the dedicated reductions of Field
+NamedCurve const& Secp256k1();
+NamedCurve const& P256();
+NamedCurve const& P384();
+
+// Curve25519 (y^2 = x^3 + 486662x^2 + x) as the short Weierstrass curve Wei25519, u = x - 486662/3
+NamedCurve const& Wei25519();
@@ -0,0 +1,452 @@
+#include <EllipticCurve/DiscreteLog.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+struct Distinguished {
+    // aP + bQ with the given x, in field representation
+    BigInt m_x;
+    BigInt m_a;
+    BigInt m_b;
+};
+
+uint64_t Mix(BigInt const& x) { return x.to_uint64() * 0x9e3779b97f4a7c15ull; }
+
+class DistinguishedTable {
+    // Open addressing over atomic pointers. An entry is published with a single compare-exchange and never
+    // moves or changes afterwards, so readers and writers need no lock.
+private:
+    std::vector<std::atomic<Distinguished*>> m_slots;
+
+public:
+    DistinguishedTable(size_t capacity)
+        : m_slots(std::bit_ceil(std::max(capacity, 1024uz)))
+    {
+    }
+
+    ~DistinguishedTable()
+    {
+        for (auto& slot : m_slots)
+            delete slot.load();
+    }
+
+    // Takes the entry and returns null, or leaves it with the caller and returns the stored entry with the same
+    // x. None when the table is full, left to the caller to stop the walks: it is called from worker threads.
+    std::optional<Distinguished const*> insert(std::unique_ptr<Distinguished>& entry)
+    {
+        auto const mask = m_slots.size() - 1;
+        auto i = static_cast<size_t>(Mix(entry->m_x) >> 16) & mask;
+
+        for (auto probes = 0uz; probes < m_slots.size(); probes++, i = (i + 1) & mask) {
+            auto* expected = static_cast<Distinguished*>(nullptr);
+
+            if (m_slots[i].compare_exchange_strong(expected, entry.get())) {
+                entry.release();
+                return nullptr;
+            }
+
+            if (expected->m_x == entry->m_x)
+                return expected;
+        }
+
+        return std::nullopt;
+    }
+};
+
+void Write(std::ofstream& file, BigInt const& value)
+{
+    auto const& groups = value.get_groups();
+    auto const size = static_cast<uint64_t>(groups.size());
+    auto const buffer = std::vector<uint32_t>(groups.begin(), groups.end());
+
+    file.write(reinterpret_cast<char const*>(&size), sizeof(size));
+    file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(uint32_t)));
+}
+
+std::optional<BigInt> Read(std::ifstream& file)
+{
+    auto size = uint64_t {};
+
+    if (!file.read(reinterpret_cast<char*>(&size), sizeof(size)) || size == 0 || size > 1024)
+        return std::nullopt;
+
+    auto buffer = std::vector<uint32_t>(size);
+
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size * sizeof(uint32_t))))
+        return std::nullopt;
+
+    return BigInt { std::deque<uint32_t>(buffer.begin(), buffer.end()) };
+}
+
+BigInt RandomBelow(BigInt const& n, std::mt19937_64& engine)
+{
+    auto groups = std::deque<uint32_t>(n.groups() + 2);
+
+    for (auto& group : groups)
+        group = static_cast<uint32_t>(engine());
+
+    return BigInt { std::move(groups) } % n;
+}
+
+std::optional<BigInt> Solve(Distinguished const& lhs, Distinguished const& rhs, Point const& P, Point const& Q, BigInt const& n)
+{
+    // a1 P + b1 Q = +-(a2 P + b2 Q) gives k = (a1 -+ a2) / (+-b2 - b1)
+    for (auto const sign : { 1, -1 }) {
+        auto const denominator = ((sign == 1 ? rhs.m_b : n - rhs.m_b) - lhs.m_b) % n;
+
+        if (denominator.is_zero())
+            continue;
+
+        auto const numerator = (lhs.m_a - (sign == 1 ? rhs.m_a : n - rhs.m_a)) % n;
+        auto const k = numerator * Modinv(denominator, n) % n;
+
+        if (P.multiply(k) == Q)
+            return k;
+    }
+
+    return std::nullopt;
+}
+}
+
+DiscreteLogResult BabyStepGiantStep(Point const& P, Point const& Q, BigInt const& order)
+{
+    // jP for j < m in a table by x, then Q - imP for i <= m until one lands in it
+    auto const start = std::chrono::steady_clock::now();
+    auto const m = static_cast<size_t>(Isqrt(order).to_uint64()) + 1;
+
+    auto result = DiscreteLogResult {};
+    auto babies = std::unordered_map<uint64_t, std::vector<size_t>> {};
+    auto J = Point::make_point_at_infinity(P.get_curve());
+
+    for (auto j = 0uz; j < m; j++, J += P) {
+        if (J.get_w() != 0)
+            babies[J.get_x().to_uint64()].push_back(j);
+    }
+
+    auto const step = -P.multiply(BigInt { static_cast<int64_t>(m) });
+    auto G = Q;
+
+    result.m_iterations = m;
+
+    for (auto i = 0uz; i <= m && !result.m_log; i++, G += step) {
+        result.m_iterations++;
+
+        auto candidates = std::vector<BigInt> {};
+
+        if (G.get_w() == 0) {
+            candidates.push_back(BigInt { static_cast<int64_t>(i) } * static_cast<uint64_t>(m));
+        } else if (auto const bucket = babies.find(G.get_x().to_uint64()); bucket != babies.end()) {
+            for (auto const j : bucket->second)
+                candidates.push_back(BigInt { static_cast<int64_t>(i) } * static_cast<uint64_t>(m) + static_cast<int64_t>(j));
+        }
+
+        for (auto const& k : candidates) {
+            if (P.multiply(k % order) == Q) {
+                result.m_log = k % order;
+                break;
+            }
+        }
+    }
+
+    result.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+DiscreteLogResult PollardRho(Point const& P, Point const& Q, BigInt const& order, PollardRhoParameters const& parameters)
+{
+    /**
+     * Parallel Pollard rho with distinguished points (van Oorschot-Wiener)
+     * Every walk steps X = aP + bQ to X + R_j, R_j = c_j P + d_j Q one of r fixed points picked by the hash of x.
+     * With the negation map X and -X are the same state, whichever has the smaller y, which shrinks the space
+     * by half. Walks report points whose hash ends in enough zero bits to a shared table; two walks that meet
+     * continue together up to the same distinguished point, and their coefficients then give k.
+     * The negation map traps walks in short fruitless cycles; a walk that returns to a marked point leaves its
+     * cycle by doubling the cycle point with the least hash, the same way for every walk that falls in.
+     * Each thread steps its walks together with BatchAdd, paying one inversion per step of all of them.
+     */
+    auto const start = std::chrono::steady_clock::now();
+    auto const& curve = P.get_curve();
+    auto const& F = curve->get_arithmetic();
+    auto const& n = order;
+
+    auto const threads = HardwareThreads(parameters.threads);
+    auto const lanes = std::max(parameters.lanes, 1uz);
+    auto const partitions = std::max(parameters.partitions, 2uz);
+
+    // About sqrt(pi n / 4) steps in total, aim for some thousands of distinguished points among them
+    auto const expected = std::sqrt(std::acos(-1.0) / 4) * std::pow(2.0, static_cast<double>(n.size()) / 2);
+    auto const walks = static_cast<double>(threads * lanes);
+    auto const bits = parameters.distinguished_bits
+        ? parameters.distinguished_bits
+        : static_cast<size_t>(std::max(0.0, std::floor(std::log2(expected / walks)) - 4));
+    auto const mask = (1ull << std::min(bits, 63uz)) - 1;
+    auto const patience = std::max<uint64_t>(1024, 16ull << std::min(bits, 48uz));
+    auto const cycle = 64uz; // Longest cycle found by the marks
+
+    auto table = DistinguishedTable { static_cast<size_t>(std::min(4 * expected / static_cast<double>(mask + 1) + 4 * walks, 1e8)) };
+
+    // The walk itself depends on the seed only, so that other processes take the same steps
+    auto R = std::vector<Coordinate> {};
+    auto c = std::vector<BigInt> {};
+    auto d = std::vector<BigInt> {};
+
+    {
+        auto engine = std::mt19937_64 { parameters.seed };
+
+        while (R.size() < partitions) {
+            auto const cj = RandomBelow(n, engine);
+            auto const dj = RandomBelow(n, engine);
+            auto const point = MultiScalarMul(std::array { P, Q }, std::array { cj, dj }, 1);
+
+            if (point.get_w() == 0)
+                continue;
+
+            R.push_back(Coordinate { F.to(point.get_x()), F.to(point.get_y()) });
+            c.push_back(cj);
+            d.push_back(dj);
+        }
+    }
+
+    auto source = std::stop_source {};
+    auto iterations = std::atomic<uint64_t> { 0 };
+    auto mutex = std::mutex {};
+    auto result = DiscreteLogResult {};
+
+    // Each process appends its own distinguished points to a file of its own in the store, named after the
+    // problem so that a store can hold several
+    auto store = std::ofstream {};
+    auto own = std::filesystem::path {};
+    auto const tag = std::to_string(Mix(P.get_x()) ^ Mix(Q.get_x()) ^ Mix(n) ^ parameters.seed) + "-";
+
+    if (!parameters.store.empty()) {
+        std::filesystem::create_directories(parameters.store);
+
+        own = parameters.store / (tag + std::to_string(std::random_device {}()) + std::to_string(std::random_device {}()) + ".dp");
+        store.open(own, std::ios::binary | std::ios::app);
+
+        if (!store)
+            throw new std::runtime_error("[PollardRho] Unable to open the distinguished point store");
+    }
+
+    auto const report = [&](std::unique_ptr<Distinguished> entry, bool local) {
+        auto const* const reported = entry.get();
+        auto const inserted = table.insert(entry);
+
+        // A full table ends the search without a logarithm, like running out of iterations
+        if (!inserted) {
+            source.request_stop();
+            return;
+        }
+
+        auto const* other = *inserted;
+
+        if (local && store.is_open()) {
+            auto lock = std::lock_guard { mutex };
+
+            Write(store, F.from(reported->m_x));
+            Write(store, reported->m_a);
+            Write(store, reported->m_b);
+            store.flush();
+        }
+
+        if (!other)
+            return;
+
+        if (auto const k = Solve(*entry, *other, P, Q, n)) {
+            auto lock = std::lock_guard { mutex };
+
+            if (!result.m_log)
+                result.m_log = k;
+
+            source.request_stop();
+        }
+    };
+
+    auto const worker = [&](std::stop_token stop) {
+        struct Walk {
+            BigInt m_a;
+            BigInt m_b;
+            uint64_t m_steps = 0;
+            uint64_t m_mark = 0;   // Hash of a point of the walk, seeing it again means a cycle
+            uint64_t m_least = 0;  // Least hash since the mark
+            size_t m_since = 0;    // Steps since the mark
+            uint64_t m_escape = 0; // Hash of the point to double to leave a cycle, 0 for none
+        };
+
+        auto engine = std::mt19937_64 { std::random_device {}() };
+        auto walks = std::vector<Walk>(lanes);
+        auto acc = std::vector<Coordinate>(lanes);
+        auto addend = std::vector<Coordinate>(lanes);
+        auto step = std::vector<size_t>(lanes);
+
+        // X and -X are one state, the representative has the smaller y
+        auto const canonical = [&](size_t lane) {
+            auto negated = F.neg(acc[lane].m_y);
+
+            if (negated < acc[lane].m_y) {
+                acc[lane].m_y = std::move(negated);
+                walks[lane].m_a = (n - walks[lane].m_a) % n;
+                walks[lane].m_b = (n - walks[lane].m_b) % n;
+            }
+        };
+
+        auto const restart = [&](size_t lane) {
+            while (true) {
+                auto a = RandomBelow(n, engine);
+                auto b = RandomBelow(n, engine);
+                auto const point = MultiScalarMul(std::array { P, Q }, std::array { a, b }, 1);
+
+                if (point.get_w() == 0)
+                    continue;
+
+                walks[lane] = Walk { std::move(a), std::move(b) };
+                acc[lane] = Coordinate { F.to(point.get_x()), F.to(point.get_y()) };
+                canonical(lane);
+                return;
+            }
+        };
+
+        for (auto lane = 0uz; lane < lanes; lane++)
+            restart(lane);
+
+        while (!stop.stop_requested()) {
+            for (auto lane = 0uz; lane < lanes; lane++) {
+                auto const key = Mix(acc[lane].m_x);
+
+                if (walks[lane].m_escape == key) {
+                    step[lane] = partitions;
+                    addend[lane] = acc[lane];
+                } else {
+                    step[lane] = static_cast<size_t>(key >> 32) % partitions;
+                    addend[lane] = R[step[lane]];
+                }
+            }
+
+            BatchAdd(*curve, acc, addend);
+
+            for (auto lane = 0uz; lane < lanes; lane++) {
+                auto& walk = walks[lane];
+
+                if (step[lane] == partitions) {
+                    walk.m_a = walk.m_a * 2 % n;
+                    walk.m_b = walk.m_b * 2 % n;
+                    walk.m_escape = 0;
+                } else {
+                    walk.m_a = (walk.m_a + c[step[lane]]) % n;
+                    walk.m_b = (walk.m_b + d[step[lane]]) % n;
+                }
+
+                if (acc[lane].m_w == 0 || ++walk.m_steps > patience) {
+                    restart(lane);
+                    continue;
+                }
+
+                canonical(lane);
+
+                auto const key = Mix(acc[lane].m_x);
+
+                if ((key & mask) == 0) {
+                    report(std::make_unique<Distinguished>(acc[lane].m_x, walk.m_a, walk.m_b), true);
+                    restart(lane);
+                    continue;
+                }
+
+                // Back at the mark, every point since is on the cycle. Leave it from the one with the least hash.
+                if (key == walk.m_mark && !walk.m_escape)
+                    walk.m_escape = walk.m_least;
+
+                if (++walk.m_since > cycle) {
+                    walk.m_mark = walk.m_least = key;
+                    walk.m_since = 0;
+                }
+
+                walk.m_least = std::min(walk.m_least, key);
+            }
+
+            auto const total = iterations += lanes;
+
+            if (parameters.max_iterations && total >= parameters.max_iterations)
+                source.request_stop();
+        }
+    };
+
+    {
+        auto pool = std::vector<std::jthread> {};
+
+        for (auto i = 0uz; i < threads; i++)
+            pool.emplace_back([&] { worker(source.get_token()); });
+
+        // Distinguished points of other processes come in through their files in the store
+        auto offsets = std::unordered_map<std::string, std::streamoff> {};
+
+        while (!source.stop_requested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            if (own.empty())
+                continue;
+
+            for (auto const& file : std::filesystem::directory_iterator(parameters.store)) {
+                if (file.path() == own || !file.path().filename().string().starts_with(tag))
+                    continue;
+
+                auto input = std::ifstream { file.path(), std::ios::binary };
+                auto& offset = offsets[file.path().string()];
+
+                input.seekg(offset);
+
+                while (true) {
+                    auto const x = Read(input);
+                    auto const a = Read(input);
+                    auto const b = Read(input);
+
+                    if (!x || !a || !b)
+                        break;
+
+                    offset = input.tellg();
+                    report(std::make_unique<Distinguished>(F.to(*x), *a, *b), false);
+                }
+            }
+        }
+    }
+
+    result.m_iterations = iterations;
+    result.m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+DiscreteLogResult DiscreteLog(Point const& P, Point const& Q, BigInt const& order, PollardRhoParameters const& parameters)
+{
+    if (P ^= Q)
+        throw new std::runtime_error("[DiscreteLog] Points are on different curves");
+
+    if (P.get_w() == 0)
+        return Q.get_w() == 0 ? DiscreteLogResult { BigInt { 0 } } : DiscreteLogResult {};
+
+    if (Q.get_w() == 0)
+        return DiscreteLogResult { BigInt { 0 } };
+
+    if (order.size() <= parameters.bsgs_bits)
+        return BabyStepGiantStep(P, Q, order);
+
+    return PollardRho(P, Q, order, parameters);
+}
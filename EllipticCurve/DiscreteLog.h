@@ -0,0 +1,34 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+// Pollard rho for the elliptic curve discrete logarithm
+struct PollardRhoParameters {
+    size_t threads = 0;             // Worker threads, 0 uses all hardware threads
+    size_t lanes = 64;              // Walks per thread, stepped together to share one inversion
+    size_t partitions = 32;         // r of the r-adding walk
+    size_t distinguished_bits = 0;  // A point is distinguished when this many bits of its hash are zero, 0 picks one
+    uint64_t max_iterations = 0;    // Walk steps over all threads before giving up, 0 is unlimited
+    uint64_t seed = 0x5eed;         // Defines the walk; processes sharing a store must agree on it
+    size_t bsgs_bits = 32;          // Orders up to this many bits are solved by baby-step giant-step instead
+    std::filesystem::path store {}; // Directory of distinguished point files shared between processes, empty for none
+};
+
+struct DiscreteLogResult {
+    std::optional<BigInt> m_log; // None when the iterations or the table of distinguished points ran out
+    uint64_t m_iterations = 0; // Group operations over all threads
+    double m_seconds = 0;
+
+    inline double rate() const { return m_seconds > 0 ? static_cast<double>(m_iterations) / m_seconds : 0; }
+};
+
+// k in [0, n) with kP = Q for P of prime order n, by Pollard rho or baby-step giant-step for small n
+DiscreteLogResult DiscreteLog(Point const& P, Point const& Q, BigInt const& order, PollardRhoParameters const& parameters = {});
+
+DiscreteLogResult PollardRho(Point const& P, Point const& Q, BigInt const& order, PollardRhoParameters const& parameters = {});
+DiscreteLogResult BabyStepGiantStep(Point const& P, Point const& Q, BigInt const& order);
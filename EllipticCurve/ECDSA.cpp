@@ -0,0 +1,246 @@
+#include <EllipticCurve/ECDSA.h>
+#include <EllipticCurve/SEC1.h>
+#include <Hash/HMAC.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+using Bytes = std::vector<uint8_t>;
+
+size_t constexpr batch = 64; // Signatures per multi-scalar multiplication in ECDSAVerify
+
+Bytes Mac(Bytes const& key, Bytes const& message)
+{
+    // HMAC_K of RFC 6979, with SHA-256
+    auto const mac = HmacSha256::mac(key, message);
+
+    return Bytes(mac.begin(), mac.end());
+}
+
+BigInt Bits2Int(std::span<uint8_t const> bytes, size_t bits)
+{
+    // Leftmost `bits` bits of the string as an integer (RFC 6979 2.3.2)
+    auto value = OctetsToInteger(bytes);
+
+    if (8 * bytes.size() > bits)
+        value >>= static_cast<int>(8 * bytes.size() - bits);
+
+    return value;
+}
+
+Bytes Concat(std::initializer_list<Bytes> parts)
+{
+    auto result = Bytes {};
+
+    for (auto const& part : parts)
+        result.insert(result.end(), part.begin(), part.end());
+
+    return result;
+}
+
+bool InRange(BigInt const& value, BigInt const& n) { return !value.is_zero() && !value.is_negative() && value < n; }
+
+bool InSubgroup(NamedCurve const& curve, Point const& point)
+{
+    // With a cofactor the curve has points outside the group generated by G, n kills only those inside it
+    return curve.m_cofactor == 1 || point.multiply(curve.m_order, ScalarMultiplication::WNAF).get_w() == 0;
+}
+
+std::optional<Point> RecoverR(NamedCurve const& curve, Signature const& signature)
+{
+    // R = kG from r and the recovery value, whose bits above the parity give j in x = r + jn
+    auto const& field = curve.m_curve->get_field();
+    auto const x = signature.m_r + curve.m_order * (signature.m_recovery >> 1);
+
+    if (x >= field)
+        return {};
+
+    auto const& F = curve.m_curve->get_arithmetic();
+    auto const X = F.to(x);
+    auto const root = F.sqrt(F.add(F.mul(F.add(F.sqr(X), curve.m_curve->get_a_field()), X), curve.m_curve->get_b_field()));
+
+    if (!root)
+        return {};
+
+    auto y = F.from(*root);
+
+    if (y.bit_at(0) != static_cast<bool>(signature.m_recovery & 1))
+        y = F.from(F.neg(*root));
+
+    return Point::make_unchecked(x, y, curve.m_curve);
+}
+
+std::vector<BigInt> Coefficients(NamedCurve const& curve, std::span<SignedHash const> batch)
+{
+    // c_i = HMAC-SHA256(SHA-256(batch), i) cut to 128 bits. Every coefficient depends on every signature, so a
+    // forger cannot pick signatures to fit coefficients known in advance; no state of a PRNG to predict either.
+    auto const length = (curve.m_curve->get_field().size() + 7) / 8;
+    auto const integer = [](uint64_t value) { return IntegerToOctets(BigInt { static_cast<int64_t>(value) }, 8); };
+    auto transcript = Sha256 {};
+
+    for (auto const& [hash, signature, key] : batch) {
+        transcript.update(integer(hash.size())).update(hash);
+        transcript.update(IntegerToOctets(signature.m_r, length)).update(IntegerToOctets(signature.m_s, length));
+        transcript.update(integer(static_cast<uint64_t>(signature.m_recovery)));
+        transcript.update(IntegerToOctets(key.get_x(), length)).update(IntegerToOctets(key.get_y(), length));
+    }
+
+    auto mac = HmacSha256 { transcript.final() };
+    auto coefficients = std::vector<BigInt> {};
+
+    for (auto i = 0uz; i < batch.size(); i++) {
+        auto const digest = mac.update(integer(i)).final();
+
+        coefficients.push_back(OctetsToInteger(std::span(digest).first(16)));
+    }
+
+    return coefficients;
+}
+
+bool BatchVerify(NamedCurve const& curve, std::span<SignedHash const> batch, size_t threads)
+{
+    auto const& n = curve.m_order;
+    auto const bits = n.size();
+
+    auto points = std::vector<Point> { curve.m_generator };
+    auto scalars = std::vector<BigInt> { 0 };
+
+    for (auto const& [hash, signature, key] : batch) {
+        if (signature.m_recovery < 0 || !InRange(signature.m_r, n) || !InRange(signature.m_s, n))
+            return false;
+
+        if (key.get_w() == 0 || (key ^= curve.m_generator) || !InSubgroup(curve, key))
+            return false;
+
+        // A torsion component in R would survive an even c, and let an invalid signature through
+        auto const R = RecoverR(curve, signature);
+
+        if (!R || !InSubgroup(curve, *R))
+            return false;
+
+        points.push_back(key);
+        points.push_back(*R);
+    }
+
+    // The coefficients hash the batch, once all of it is known to be well formed
+    auto const coefficients = Coefficients(curve, batch);
+
+    for (auto i = 0uz; i < batch.size(); i++) {
+        auto const& [hash, signature, key] = batch[i];
+        auto const& c = coefficients[i];
+
+        auto const w = Modinv(signature.m_s, n);
+        auto const cw = c * w % n;
+
+        scalars[0] = (scalars[0] + Bits2Int(hash, bits) % n * cw) % n;
+        scalars.push_back(signature.m_r * cw % n);
+        scalars.push_back(-c);
+    }
+
+    return MultiScalarMul(points, scalars, threads).get_w() == 0;
+}
+}
+
+Point ECDSAPublicKey(NamedCurve const& curve, BigInt const& key)
+{
+    return curve.m_generator.multiply(key, ScalarMultiplication::Ladder);
+}
+
+Signature ECDSASign(NamedCurve const& curve, BigInt const& key, std::span<uint8_t const> hash)
+{
+    // RFC 6979 3.2, with HMAC-SHA256 as the generator
+    auto const& n = curve.m_order;
+    auto const bits = n.size();
+    auto const length = (bits + 7) / 8;
+
+    // A key past n would be cut to its low bytes in the nonce input but not in s, and keys sharing those
+    // bytes would share nonces
+    if (!InRange(key, n))
+        throw new std::runtime_error("[ECDSA] Private key must be in [1, n)");
+
+    auto const z = Bits2Int(hash, bits);
+    auto const secret = IntegerToOctets(key, length);
+    auto const digest = IntegerToOctets(z % n, length);
+
+    auto V = Bytes(32, 0x01);
+    auto K = Bytes(32, 0x00);
+
+    K = Mac(K, Concat({ V, { 0x00 }, secret, digest }));
+    V = Mac(K, V);
+    K = Mac(K, Concat({ V, { 0x01 }, secret, digest }));
+    V = Mac(K, V);
+
+    while (true) {
+        auto T = Bytes {};
+
+        while (8 * T.size() < bits) {
+            V = Mac(K, V);
+            T.insert(T.end(), V.begin(), V.end());
+        }
+
+        auto const k = Bits2Int(T, bits);
+
+        if (InRange(k, n)) {
+            // The nonce is secret, its multiple goes through the ladder
+            auto const R = curve.m_generator.multiply(k, ScalarMultiplication::Ladder);
+            auto const r = R.get_x() % n;
+            auto const s = Modinv(k, n) * ((z + r * key) % n) % n;
+
+            if (!r.is_zero() && !s.is_zero())
+                return Signature { r, s, static_cast<int>(R.get_y().bit_at(0)) | static_cast<int>((R.get_x() / n).to_uint64() << 1) };
+        }
+
+        K = Mac(K, Concat({ V, { 0x00 } }));
+        V = Mac(K, V);
+    }
+}
+
+bool ECDSAVerify(NamedCurve const& curve, std::span<uint8_t const> hash, Signature const& signature, Point const& key)
+{
+    auto const& n = curve.m_order;
+
+    if (!InRange(signature.m_r, n) || !InRange(signature.m_s, n))
+        return false;
+
+    if (key.get_w() == 0 || (key ^= curve.m_generator) || !InSubgroup(curve, key))
+        return false;
+
+    auto const w = Modinv(signature.m_s, n);
+    auto const points = std::array<Point, 2> { curve.m_generator, key };
+    auto const scalars = std::array<BigInt, 2> { Bits2Int(hash, n.size()) % n * w % n, signature.m_r * w % n };
+
+    auto const X = MultiScalarMul(points, scalars);
+
+    return X.get_w() != 0 && X.get_x() % n == signature.m_r;
+}
+
+bool ECDSABatchVerify(NamedCurve const& curve, std::span<SignedHash const> batch)
+{
+    return BatchVerify(curve, batch, 0);
+}
+
+std::vector<uint8_t> ECDSAVerify(NamedCurve const& curve, std::span<SignedHash const> signatures, size_t threads)
+{
+    auto valid = std::vector<uint8_t>(signatures.size());
+
+    ParallelFor((signatures.size() + batch - 1) / batch, threads, [&](size_t group) {
+        auto const begin = group * batch;
+        auto const chunk = signatures.subspan(begin, std::min(batch, signatures.size() - begin));
+
+        if (BatchVerify(curve, chunk, 1)) {
+            std::fill_n(valid.begin() + static_cast<ptrdiff_t>(begin), chunk.size(), 1);
+            return;
+        }
+
+        for (auto i = 0uz; i < chunk.size(); i++)
+            valid[begin + i] = ECDSAVerify(curve, chunk[i].m_hash, chunk[i].m_signature, chunk[i].m_key);
+    });
+
+    return valid;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/Curves.h>
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Signature {
+    BigInt m_r;
+    BigInt m_s;
+    // Parity of y(kG) in bit 0 and j = x(kG) / n above it, so x(kG) = r + jn; j reaches the cofactor on curves
+    // with p > n. Lets batch verification rebuild R from r; -1 when unknown
+    int m_recovery = -1;
+};
+
+struct SignedHash {
+    // One signature to verify: message hash, signature and public key
+    std::span<uint8_t const> m_hash;
+    Signature m_signature;
+    Point m_key;
+};
+
+/**
+ * ECDSA over a named curve, in the subgroup of prime order n generated by G
+ * The hash is reduced to its leftmost bits(n) bits. On curves with a cofactor, public keys outside that subgroup
+ * are rejected. Nonces are deterministic (RFC 6979 with HMAC-SHA256),
+ * derived from the private key and the hash, so that signing needs no randomness.
+ */
+Point ECDSAPublicKey(NamedCurve const& curve, BigInt const& key);
+Signature ECDSASign(NamedCurve const& curve, BigInt const& key, std::span<uint8_t const> hash);
+
+// u1 G + u2 Q with u1 = z / s and u2 = r / s in one interleaved pass (Shamir's trick)
+bool ECDSAVerify(NamedCurve const& curve, std::span<uint8_t const> hash, Signature const& signature, Point const& key);
+
+// Checks sum c_i (u1_i G + u2_i Q_i - R_i) = O with a single multi-scalar multiplication, for 128-bit c_i
+// derived by HMAC-SHA256 from a hash of the whole batch.
+// Needs the recovery parity of every signature; a failing batch says nothing about which signature is bad.
+bool ECDSABatchVerify(NamedCurve const& curve, std::span<SignedHash const> batch);
+
+// Validity of every signature, verified in batches over threads. A batch that fails is verified one by one.
+std::vector<uint8_t> ECDSAVerify(NamedCurve const& curve, std::span<SignedHash const> signatures, size_t threads = 0);
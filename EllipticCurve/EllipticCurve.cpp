@@ -1,42 +1,409 @@
+#include <EllipticCurve/Curves.h>
 #include <EllipticCurve/EllipticCurve.h>
+#include <EllipticCurve/FixedField.h>
 #include <Modmath.h>
 
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+// The group law in Jacobian coordinates, over either field backend: F is a Field or a FixedField, and P any
+// coordinate with members m_x, m_y and m_z in its representation
+
+template<class Element>
+struct Jacobian {
+    Element m_x;
+    Element m_y;
+    Element m_z;
+};
+
+template<class Arithmetic, class Coordinates>
+void Double(Arithmetic const& F, Coordinates& P, typename Arithmetic::Element const& a)
+{
+    // dbl-1998-cmo-2: S = 4XY^2, M = 3X^2 + aZ^4, X' = M^2 - 2S, Y' = M(S - X') - 8Y^4, Z' = 2YZ
+    if (F.is_zero(P.m_z))
+        return;
+
+    auto& [X, Y, Z] = P;
+
+    auto const twice = [&F](auto const& x) { return F.add(x, x); };
+
+    auto const YY = F.sqr(Y);
+    auto const XX = F.sqr(X);
+    auto const S = twice(twice(F.mul(X, YY)));
+    auto const M = F.add(F.add(twice(XX), XX), F.mul(a, F.sqr(F.sqr(Z))));
+    auto const YYYY8 = twice(twice(twice(F.sqr(YY))));
+
+    Z = twice(F.mul(Y, Z));
+    X = F.sub(F.sqr(M), twice(S));
+    Y = F.sub(F.mul(M, F.sub(S, X)), YYYY8);
+}
+
+template<class Arithmetic, class Coordinates>
+void Add(Arithmetic const& F, Coordinates& P, Coordinates const& Q, typename Arithmetic::Element const& a)
+{
+    // add-1998-cmo-2
+    if (F.is_zero(Q.m_z))
+        return;
+
+    if (F.is_zero(P.m_z)) {
+        P = Q;
+        return;
+    }
+
+    auto& [X1, Y1, Z1] = P;
+    auto const& [X2, Y2, Z2] = Q;
+
+    auto const Z1Z1 = F.sqr(Z1);
+    auto const Z2Z2 = F.sqr(Z2);
+    auto const U1 = F.mul(X1, Z2Z2);
+    auto const U2 = F.mul(X2, Z1Z1);
+    auto const S1 = F.mul(Y1, F.mul(Z2, Z2Z2));
+    auto const S2 = F.mul(Y2, F.mul(Z1, Z1Z1));
+    auto const H = F.sub(U2, U1);
+    auto const r = F.sub(S2, S1);
+
+    if (F.is_zero(H)) {
+        if (F.is_zero(r))
+            return Double(F, P, a);
+
+        Z1 = F.zero();
+        return;
+    }
+
+    auto const HH = F.sqr(H);
+    auto const HHH = F.mul(H, HH);
+    auto const V = F.mul(U1, HH);
+
+    X1 = F.sub(F.sub(F.sqr(r), HHH), F.add(V, V));
+    Y1 = F.sub(F.mul(r, F.sub(V, X1)), F.mul(S1, HHH));
+    Z1 = F.mul(F.mul(Z1, Z2), H);
+}
+
+template<class Arithmetic, class Coordinates>
+void AddAffine(Arithmetic const& F, Coordinates& P, typename Arithmetic::Element const& x, typename Arithmetic::Element const& y,
+               typename Arithmetic::Element const& a)
+{
+    // madd-2004-hmv, the add-1998-cmo-2 formulas with Z2 = 1
+    if (F.is_zero(P.m_z)) {
+        P = Coordinates { x, y, F.one() };
+        return;
+    }
+
+    auto& [X1, Y1, Z1] = P;
+
+    auto const Z1Z1 = F.sqr(Z1);
+    auto const U2 = F.mul(x, Z1Z1);
+    auto const S2 = F.mul(y, F.mul(Z1, Z1Z1));
+    auto const H = F.sub(U2, X1);
+    auto const r = F.sub(S2, Y1);
+
+    if (F.is_zero(H)) {
+        if (F.is_zero(r))
+            return Double(F, P, a);
+
+        Z1 = F.zero();
+        return;
+    }
+
+    auto const HH = F.sqr(H);
+    auto const HHH = F.mul(H, HH);
+    auto const V = F.mul(X1, HH);
+
+    X1 = F.sub(F.sub(F.sqr(r), HHH), F.add(V, V));
+    Y1 = F.sub(F.mul(r, F.sub(V, X1)), F.mul(Y1, HHH));
+    Z1 = F.mul(Z1, H);
+}
+
+// Renes, Costello and Batina, "Complete addition formulas for prime order elliptic curves" (2016), on
+// homogeneous projective (X : Y : Z) with the point at infinity (0 : 1 : 0). The same operations for every
+// input, the point at infinity and P = Q included; on a curve of even order addition fails only when P - Q
+// has order 2. b3 is 3b.
+
+template<class Arithmetic, class Coordinates>
+void CompleteAdd(Arithmetic const& F, Coordinates& P, Coordinates const& Q, typename Arithmetic::Element const& a,
+                 typename Arithmetic::Element const& b3)
+{
+    // Algorithm 1
+    auto const& [X1, Y1, Z1] = P;
+    auto const& [X2, Y2, Z2] = Q;
+
+    auto t0 = F.mul(X1, X2);
+    auto t1 = F.mul(Y1, Y2);
+    auto t2 = F.mul(Z1, Z2);
+    auto t3 = F.mul(F.add(X1, Y1), F.add(X2, Y2));
+    t3 = F.sub(t3, F.add(t0, t1));
+    auto t4 = F.mul(F.add(X1, Z1), F.add(X2, Z2));
+    t4 = F.sub(t4, F.add(t0, t2));
+    auto t5 = F.mul(F.add(Y1, Z1), F.add(Y2, Z2));
+    t5 = F.sub(t5, F.add(t1, t2));
+
+    auto Z3 = F.add(F.mul(b3, t2), F.mul(a, t4));
+    auto X3 = F.sub(t1, Z3);
+    Z3 = F.add(t1, Z3);
+    auto Y3 = F.mul(X3, Z3);
+
+    t1 = F.add(F.add(t0, t0), t0);
+    t2 = F.mul(a, t2);
+    t4 = F.mul(b3, t4);
+    t1 = F.add(t1, t2);
+    t2 = F.mul(a, F.sub(t0, t2));
+    t4 = F.add(t4, t2);
+    Y3 = F.add(Y3, F.mul(t1, t4));
+    X3 = F.sub(F.mul(t3, X3), F.mul(t5, t4));
+    Z3 = F.add(F.mul(t5, Z3), F.mul(t3, t1));
+
+    P = Coordinates { std::move(X3), std::move(Y3), std::move(Z3) };
+}
+
+template<class Arithmetic, class Coordinates>
+void CompleteDouble(Arithmetic const& F, Coordinates& P, typename Arithmetic::Element const& a, typename Arithmetic::Element const& b3)
+{
+    // Algorithm 3
+    auto const& [X, Y, Z] = P;
+
+    auto t0 = F.sqr(X);
+    auto const t1 = F.sqr(Y);
+    auto t2 = F.sqr(Z);
+    auto t3 = F.mul(X, Y);
+    t3 = F.add(t3, t3);
+    auto Z3 = F.mul(X, Z);
+    Z3 = F.add(Z3, Z3);
+
+    auto X3 = F.mul(a, Z3);
+    auto Y3 = F.add(X3, F.mul(b3, t2));
+    X3 = F.sub(t1, Y3);
+    Y3 = F.mul(X3, F.add(t1, Y3));
+    X3 = F.mul(t3, X3);
+    Z3 = F.mul(b3, Z3);
+
+    t2 = F.mul(a, t2);
+    t3 = F.add(F.mul(a, F.sub(t0, t2)), Z3);
+    t0 = F.add(F.add(F.add(t0, t0), t0), t2);
+    Y3 = F.add(Y3, F.mul(t0, t3));
+
+    t2 = F.mul(Y, Z);
+    t2 = F.add(t2, t2);
+    X3 = F.sub(X3, F.mul(t2, t3));
+    Z3 = F.mul(t2, t1);
+    Z3 = F.add(Z3, Z3);
+    Z3 = F.add(Z3, Z3);
+
+    P = Coordinates { std::move(X3), std::move(Y3), std::move(Z3) };
+}
+
+template<class Arithmetic, class Coordinates>
+Point ToAffine(Arithmetic const& F, CurveContext const& curve, Coordinates const& P)
+{
+    // (X / Z^2, Y / Z^3), the only inversion
+    if (F.is_zero(P.m_z))
+        return Point::make_point_at_infinity(curve);
+
+    auto const zinv = F.inv(P.m_z);
+    auto const zinv2 = F.sqr(zinv);
+
+    return Point::make_unchecked(F.from(F.mul(P.m_x, zinv2)), F.from(F.mul(P.m_y, F.mul(zinv2, zinv))), curve);
+}
+
+template<class Arithmetic>
+Point Multiply(Arithmetic const& F, CurveContext const& curve, Point const& P, BigInt const& k, ScalarMultiplication method)
+{
+    using Coordinates = Jacobian<typename Arithmetic::Element>;
+
+    auto const a = F.to(curve->get_a());
+    // The same (X : Y : Z) in Jacobian and in homogeneous projective coordinates
+    auto const base = Coordinates { F.to(P.get_x()), F.to(P.get_y()), F.one() };
+    auto const infinity = Coordinates { F.zero(), F.one(), F.zero() };
+
+    switch (method) {
+    case ScalarMultiplication::WNAF: {
+        auto const w = k.size() > 256 ? 6uz : k.size() > 64 ? 5uz : 4uz;
+        auto const naf = wNAF(k, w);
+
+        // Odd multiples P, 3P, ..., (2^(w - 1) - 1)P
+        auto table = std::vector<Coordinates>(1uz << (w - 2), base);
+        auto P2 = base;
+        Double(F, P2, a);
+
+        for (auto i = 1uz; i < table.size(); i++)
+            Add(F, table[i] = table[i - 1], P2, a);
+
+        auto R = infinity;
+
+        for (auto i = naf.size(); i-- > 0;) {
+            Double(F, R, a);
+
+            if (naf[i] > 0) {
+                Add(F, R, table[naf[i] / 2], a);
+            } else if (naf[i] < 0) {
+                auto const& T = table[-naf[i] / 2];
+                Add(F, R, Coordinates { T.m_x, F.neg(T.m_y), T.m_z }, a);
+            }
+        }
+
+        return ToAffine(F, curve, R);
+    }
+    case ScalarMultiplication::Ladder: {
+        // Invariant R1 - R0 = P, every bit costs one complete addition and one complete doubling, so the
+        // leading zero bits run through the point at infinity like any other. Scalars are read from limbs
+        // padded to the field size, a fixed length for every k below 2^|p|, and conditional swaps replace
+        // any branch on the key bits. Constant time on FixedField only, see Field::cswap.
+        // The one input outside the formulas: R1 - R0 = P of order 2, and then [k]P is P or O by parity
+        if (P.get_y().is_zero())
+            return k.bit_at(0) ? P : Point::make_point_at_infinity(curve);
+
+        auto const b3 = F.to(curve->get_b() * 3);
+        auto const bits = std::max(k.size(), curve->get_field().size());
+        auto limbs = std::vector<uint32_t>((bits + 31) / 32);
+
+        std::ranges::copy(k.get_groups(), limbs.begin());
+
+        auto R0 = infinity;
+        auto R1 = base;
+        auto swapped = false;
+
+        auto const cswap = [&F](Coordinates& lhs, Coordinates& rhs, bool swap) {
+            F.cswap(lhs.m_x, rhs.m_x, swap);
+            F.cswap(lhs.m_y, rhs.m_y, swap);
+            F.cswap(lhs.m_z, rhs.m_z, swap);
+        };
+
+        for (auto i = bits; i-- > 0;) {
+            auto const bit = static_cast<bool>(limbs[i / 32] >> (i % 32) & 1);
+
+            cswap(R0, R1, swapped ^ bit);
+            swapped = bit;
+
+            CompleteAdd(F, R1, R0, a, b3);
+            CompleteDouble(F, R0, a, b3);
+        }
+
+        cswap(R0, R1, swapped);
+
+        if (F.is_zero(R0.m_z))
+            return Point::make_point_at_infinity(curve);
+
+        auto const zinv = F.inv(R0.m_z);
+
+        return Point::make_unchecked(F.from(F.mul(R0.m_x, zinv)), F.from(F.mul(R0.m_y, zinv)), curve);
+    }
+    }
+
+    ASSERT_NOT_REACHED;
+    return P;
+}
+}
+
+std::vector<int8_t> wNAF(BigInt const& k, size_t w)
+{
+    // Digits are zero or odd with |d| < 2^(w - 1)
+    auto const length = k.size();
+    auto naf = std::vector<int8_t>(length + 1);
+    auto carry = 0u;
+
+    for (auto bit = 0uz; bit < length;) {
+        if (k.bit_at(bit) == carry) {
+            bit++;
+            continue;
+        }
+
+        auto const now = std::min(w, length - bit);
+        auto word = carry;
+
+        for (auto j = 0uz; j < now; j++)
+            word += static_cast<unsigned>(k.bit_at(bit + j)) << j;
+
+        carry = (word >> (w - 1)) & 1;
+        naf[bit] = static_cast<int8_t>(static_cast<int>(word) - static_cast<int>(carry << w));
+        bit += now;
+    }
+
+    naf[length] = static_cast<int8_t>(carry);
+
+    return naf;
+}
+
 void EllipticCurve::generate_points()
 {
-    for (auto y = BigInt {}; y < m_field; y += 1) {
-        // Find quadratic residues in m_field
-        auto y2 = Modexp(y, 2, m_field);
+    // One residue test per x, and a square root for the residues, O(p log p)
+    auto const& field = m_curve->get_field();
+
+    for (auto x = BigInt {}; x < field; x += 1) {
+        auto const value = (x * (x * x + m_curve->get_a()) + m_curve->get_b()) % field;
+
+        if (value.is_zero()) {
+            m_points.push_back(Point::make_unchecked(x, 0, m_curve));
+            continue;
+        }
+
+        if (auto const y = Modsqrt(value, field)) {
+            m_points.push_back(Point::make_unchecked(x, *y, m_curve));
+            m_points.push_back(Point::make_unchecked(x, field - *y, m_curve));
+        }
+    }
+}
+
+BigInt EllipticCurve::get_order()
+{
+    if (m_order)
+        return *m_order;
+
+    auto const& field = m_curve->get_field();
 
-        for (auto x = BigInt {}; x < m_field; x += 1) {
-            auto value = (x * (x * x + m_a) + m_b) % m_field;
+    if (((m_curve->get_a() * m_curve->get_a() * m_curve->get_a() * 4) + (m_curve->get_b() * m_curve->get_b() * 27)) % field == 0)
+        throw new std::runtime_error("[EllipticCurve] Singular curve has no group order");
 
-            if (y2 == value)
-                m_points.push_back(Point(x, y, m_a, m_b, m_field));
+    // The standard curves have published orders, far out of reach of point counting
+    for (auto const* named : { &Secp256k1(), &P256(), &P384(), &Wei25519() }) {
+        if (*named->m_curve == *m_curve) {
+            m_order = named->m_order * named->m_cofactor;
+            return *m_order;
         }
     }
+
+    if (field.size() <= 10) {
+        m_order = BigInt { static_cast<int64_t>(get_points().size()) + 1 };
+    } else if (field.size() <= 64) {
+        m_order = MestreOrder(m_curve);
+    } else {
+        m_order = SchoofOrder(m_curve);
+    }
+
+    return *m_order;
 }
 
-bool Point::is_on_curve()
+bool Point::is_on_curve() const
 {
     if (get_w() == 0)
         return true;
 
-    auto y2 = Modexp(get_y(), 2, get_field());
-    auto val = (get_x() * (get_x() * get_x() + get_a()) + get_b()) % get_field();
+    // y^2 = x^3 + ax + b in field representation
+    auto const& F = m_curve->get_arithmetic();
+    auto const x = F.to(get_x());
+    auto const rhs = F.add(F.mul(F.add(F.sqr(x), m_curve->get_a_field()), x), m_curve->get_b_field());
 
-    return y2 == val;
+    return F.sqr(F.to(get_y())) == rhs;
 }
 
-void Point::check_validity()
+void Point::check_validity() const
 {
-    assert(is_on_curve());
+    if (get_w() == 0)
+        return;
+
+    auto const& field = get_field();
+
+    if (get_x().is_negative() || get_x() >= field || get_y().is_negative() || get_y() >= field)
+        throw new std::runtime_error("[Point] Coordinate out of range");
+
+    if (!is_on_curve())
+        throw new std::runtime_error("[Point] Point is not on the curve");
 }
 
 Point Point::operator-() const
 {
     auto result = Point { *this };
 
-    result.m_coord.m_y = get_field() - get_y();
+    result.m_coord.m_y = m_curve->get_arithmetic().neg(get_y());
 
     return result;
 }
@@ -45,10 +412,6 @@ Point& Point::operator+=(Point const& rhs)
 {
     assert(*this |= rhs);
 
-    // If both points are inf, return inf
-    if (get_w() == 0 && rhs.get_w() == 0)
-        return Point::set_point_at_infinity(*this);
-
     // If either are points at infinity, then return the other
     if (get_w() == 0) {
         *this = rhs;
@@ -58,37 +421,9 @@ Point& Point::operator+=(Point const& rhs)
     if (rhs.get_w() == 0)
         return *this;
 
-    // Given points L, R on E(F_p), if L.x == R.x return inf
-    if (*this != rhs && get_x() == rhs.get_x())
-        return Point::set_point_at_infinity(*this);
-
-    auto lambda = BigInt {};
-    auto const field = get_field();
-
-    auto const lx = get_x();
-    auto const ly = get_y();
-
-    auto const rx = rhs.get_x();
-    auto const ry = rhs.get_y();
-
-    if (*this == rhs) // Point doubling
-        lambda = ((lx * lx) * 3 + get_a()) * Modinv(ly * 2, field);
-    else
-        lambda = ((ry - ly) % field) * Modinv((rx - lx) % field, field);
-
-    lambda %= field;
-
-    auto xn = (Modexp(lambda, 2, field) - (lx + rx)) % field;
-    auto yn = (lambda * (lx - xn) - ly) % field;
-
-    // Check if on curve
+    *this = (JacobianPoint { *this } += rhs).to_affine();
 
-    m_coord = Coordinate { xn, yn };
-
-    if (is_on_curve())
-        return *this;
-
-    return Point::set_point_at_infinity(*this);
+    return *this;
 }
 
 Point& Point::operator-=(Point const& rhs)
@@ -113,87 +448,120 @@ Point Point::operator-(Point const& rhs) const
     return result -= rhs;
 }
 
-Point& Point::operator*=(int64_t rhs)
+Point& Point::operator*=(BigInt const& rhs)
 {
-    if (rhs == 1)
-        return *this;
+    *this = multiply(rhs);
 
-    if (rhs == -1) {
-        *this = -*this;
-        return *this;
-    }
+    return *this;
+}
 
-    auto nrhs = rhs;
-    auto P = *this;
+Point operator*(BigInt const& lhs, Point const& rhs) { return rhs.multiply(lhs); }
+Point operator*(Point const& lhs, BigInt const& rhs) { return lhs.multiply(rhs); }
 
-    if (rhs < 0) {
-        nrhs *= -1;
-        P = -*this;
-    }
+Point Point::multiply(BigInt const& scalar, ScalarMultiplication method) const
+{
+    if (scalar.is_zero() || get_w() == 0)
+        return Point::make_point_at_infinity(m_curve);
 
-    auto const m = (sizeof(rhs) * 8) - __builtin_clzll(nrhs);
-    Point::set_point_at_infinity(*this);
+    auto const P = scalar.is_negative() ? -*this : *this;
+    auto const k = scalar.abs();
 
-#ifdef MONTGOMERY
-    // Perform the Montgomery ladder method of point addition
-    // Computes point multiplication in fixed time
-    for (auto i = m; i-- > 0;) {
-        if (nrhs & (1 << i)) {
-            *this += P;
-            P += P;
+    return WithFixedField(m_curve->get_arithmetic(), [&](auto const& F) { return Multiply(F, m_curve, P, k, method); });
+}
 
-            continue;
-        }
+bool Point::operator|=(Point const& rhs) const { return m_curve == rhs.m_curve || *m_curve == *rhs.m_curve; }
+bool Point::operator^=(Point const& rhs) const { return !(*this |= rhs); }
 
-        P += *this;
-        *this += *this;
-    }
-#else
-    // Similar to fast powering impl in Modexp from Modmath.h
-    // Vulnerable to side-channel attacks
-    if (rhs == 0)
-        return *this;
+bool Point::operator==(Point const& rhs) const
+{
+    if (*this ^= rhs)
+        return false;
+
+    if (get_w() == 0 && rhs.get_w() == 0)
+        return true;
 
-    for (auto i = m; i-- > 0;) {
-        *this += *this;
+    return get_w() == rhs.get_w() && (get_x() == rhs.get_x()) && (get_y() == rhs.get_y());
+}
+bool Point::operator!=(Point const& rhs) const { return !(*this == rhs); }
 
-        if (nrhs & (1 << i))
-            *this += P;
+std::ostream& operator<<(std::ostream& stream, Point const& point)
+{
+    if (point.get_w() == 0)
+        return stream << "inf";
+
+    return stream << "(" << point.get_x() << ", " << point.get_y() << ")";
+}
+
+JacobianPoint::JacobianPoint(CurveContext curve)
+    : m_curve(std::move(curve))
+    , m_coord(JacobianCoordinate { 0, m_curve->get_arithmetic().one(), 0 })
+{
+}
+
+JacobianPoint::JacobianPoint(Point const& point)
+    : m_curve(point.get_curve())
+{
+    auto const& F = m_curve->get_arithmetic();
+
+    if (point.get_w() == 0) {
+        m_coord = JacobianCoordinate { 0, F.one(), 0 };
+        return;
     }
-#endif
+
+    m_coord = JacobianCoordinate { F.to(point.get_x()), F.to(point.get_y()), F.one() };
+}
+
+JacobianPoint& JacobianPoint::dbl()
+{
+    Double(m_curve->get_arithmetic(), m_coord, m_curve->get_a_field());
+
+    return *this;
+}
+
+JacobianPoint& JacobianPoint::operator+=(JacobianPoint const& rhs)
+{
+    Add(m_curve->get_arithmetic(), m_coord, rhs.m_coord, m_curve->get_a_field());
 
     return *this;
 }
 
-Point operator*(int64_t lhs, Point const& rhs)
+JacobianPoint& JacobianPoint::operator+=(Point const& rhs)
 {
-    auto result = rhs;
+    if (rhs.get_w() == 0)
+        return *this;
+
+    auto const& F = m_curve->get_arithmetic();
 
-    return result *= lhs;
+    return add_affine(Coordinate { F.to(rhs.get_x()), F.to(rhs.get_y()) });
 }
 
-Point operator*(Point const& lhs, int64_t rhs) { return rhs * lhs; }
+JacobianPoint& JacobianPoint::add_affine(Coordinate const& rhs)
+{
+    if (rhs.m_w == 0)
+        return *this;
+
+    AddAffine(m_curve->get_arithmetic(), m_coord, rhs.m_x, rhs.m_y, m_curve->get_a_field());
 
-// return true if points are on same curve
-inline bool Point::operator|=(Point const& rhs) { return static_cast<Curve>(*this) == static_cast<Curve>(rhs); }
-inline bool Point::operator^=(Point const& rhs) { return !(*this |= rhs); }
+    return *this;
+}
 
-inline bool Point::operator==(Point const& rhs)
+JacobianPoint JacobianPoint::operator-() const
 {
-    if (*this ^= rhs)
-        return false;
+    auto result = *this;
 
-    if (get_w() == 0 && rhs.get_w() == 0)
-        return true;
+    result.m_coord.m_y = m_curve->get_arithmetic().neg(m_coord.m_y);
 
-    return (get_x() == rhs.get_x()) && (get_y() == rhs.get_y());
+    return result;
 }
-inline bool Point::operator!=(Point const& rhs) { return !(*this == rhs); }
 
-std::ostream& operator<<(std::ostream& stream, Point const& point)
+void JacobianPoint::cswap(JacobianPoint& lhs, JacobianPoint& rhs, bool swap)
 {
-    if (point.get_w() == 0)
-        return stream << "inf";
+    // Both sides are always touched, the swap is a mask over the coordinates
+    auto const& F = lhs.m_curve->get_arithmetic();
 
-    return stream << "(" << point.get_x() << ", " << point.get_y() << ")";
+    F.cswap(lhs.m_coord.m_x, rhs.m_coord.m_x, swap);
+    F.cswap(lhs.m_coord.m_y, rhs.m_coord.m_y, swap);
+    F.cswap(lhs.m_coord.m_z, rhs.m_coord.m_z, swap);
 }
+
+Point JacobianPoint::to_affine() const { return ToAffine(m_curve->get_arithmetic(), m_curve, m_coord); }
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <BigInt/BigInt.h>
+#include <EllipticCurve/Field.h>
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <ostream>
+#include <span>
 #include <vector>
 
 #define ASSERT_NOT_REACHED assert(false)
@@ -16,21 +20,47 @@ struct Coordinate {
     bool m_w = 1; // w is 0 for point at infinity; 1 otherwise
 };
 
-class EllipticCurve;
+struct JacobianCoordinate {
+    // Jacobian coordinate (X : Y : Z) of the affine point (X / Z^2, Y / Z^3); Z = 0 for the point at infinity
+    BigInt m_x;
+    BigInt m_y;
+    BigInt m_z;
+};
+
+enum class ScalarMultiplication {
+    // Width-w NAF recoding over precomputed odd multiples, variable time
+    WNAF,
+    // Montgomery ladder on complete formulas, the same sequence of field operations for every scalar below
+    // 2^|p|; constant time for the primes with a FixedField backend
+    Ladder,
+};
 
 class Curve {
+    // Immutable curve parameters, shared by every point on the curve through a shared_ptr<Curve const>.
+    // Also holds the precomputed state for field arithmetic, with a and b already in field representation.
 public:
-    Curve() { ASSERT_NOT_REACHED; }
     Curve(BigInt a, BigInt b, BigInt field)
         : m_field(field)
-        , m_a(a)
-        , m_b(b)
+        , m_a(a % field)
+        , m_b(b % field)
+        , m_arithmetic(field)
+        , m_a_field(m_arithmetic.to(m_a))
+        , m_b_field(m_arithmetic.to(m_b))
     {
     }
 
-    inline BigInt get_field() const { return m_field; };
-    inline BigInt get_a() const { return m_a; };
-    inline BigInt get_b() const { return m_b; };
+    static inline std::shared_ptr<Curve const> make(BigInt a, BigInt b, BigInt field)
+    {
+        return std::make_shared<Curve const>(std::move(a), std::move(b), std::move(field));
+    }
+
+    inline BigInt const& get_field() const { return m_field; };
+    inline BigInt const& get_a() const { return m_a; };
+    inline BigInt const& get_b() const { return m_b; };
+
+    inline Field const& get_arithmetic() const { return m_arithmetic; }
+    inline BigInt const& get_a_field() const { return m_a_field; }
+    inline BigInt const& get_b_field() const { return m_b_field; }
 
     inline friend bool operator==(Curve const& lhs, Curve const& rhs)
     {
@@ -42,52 +72,77 @@ public:
     inline friend bool operator!=(Curve const& lhs, Curve const& rhs) { return !(lhs == rhs); }
 
 private:
-    friend class EllipticCurve;
     BigInt m_field;
     BigInt m_a;
     BigInt m_b;
+
+    Field m_arithmetic;
+    BigInt m_a_field; // aR
+    BigInt m_b_field; // bR
 };
 
-class Point : public Curve {
+using CurveContext = std::shared_ptr<Curve const>;
+
+class Point {
 private:
+    CurveContext m_curve;
     Coordinate m_coord;
 
-    bool is_on_curve();
-    void check_validity();
+    bool is_on_curve() const;
+    void check_validity() const;
+
+    // Group operations only produce points on the curve, their results skip the check
+    struct Unchecked { };
+
+    Point(Coordinate coord, CurveContext curve, Unchecked)
+        : m_curve(std::move(curve))
+        , m_coord(std::move(coord))
+    {
+#ifdef VALIDATE_POINTS
+        assert(is_on_curve());
+#endif
+    }
 
 public:
+    // Constructors are the trust boundary and throw for coordinates outside [0, p) or off the curve
     Point(BigInt x, BigInt y, BigInt a, BigInt b, BigInt field)
-        : Curve(a, b, field)
+        : m_curve(Curve::make(a, b, field))
         , m_coord(Coordinate(x, y))
     {
         check_validity();
     }
 
-    Point(BigInt x, BigInt y, Curve const& curve)
-        : Curve(curve)
+    Point(BigInt x, BigInt y, CurveContext curve)
+        : m_curve(std::move(curve))
         , m_coord(Coordinate(x, y))
     {
         check_validity();
     }
 
     Point(Coordinate coord, BigInt a, BigInt b, BigInt field)
-        : Curve(a, b, field)
+        : m_curve(Curve::make(a, b, field))
         , m_coord(coord)
     {
         check_validity();
     }
 
-    Point(Coordinate coord, Curve const& curve)
-        : Curve(curve)
+    Point(Coordinate coord, CurveContext curve)
+        : m_curve(std::move(curve))
         , m_coord(coord)
     {
         check_validity();
     }
 
-    template <typename T>
-    static inline Point make_point_at_infinity(T curve)
+    static inline Point make_point_at_infinity(CurveContext curve)
     {
-        return Point { Coordinate { 0, 0, 0 }, static_cast<Curve>(curve) };
+        return Point { Coordinate { 0, 0, 0 }, std::move(curve), Unchecked {} };
+    }
+
+    // For coordinates already known to be on the curve: results of group arithmetic or validated input.
+    // Only checked when built with VALIDATE_POINTS.
+    static inline Point make_unchecked(BigInt x, BigInt y, CurveContext curve)
+    {
+        return Point { Coordinate { std::move(x), std::move(y) }, std::move(curve), Unchecked {} };
     }
 
     static inline Point& set_point_at_infinity(Point& point)
@@ -96,51 +151,114 @@ public:
         return point;
     }
 
-    BigInt get_x() const { return m_coord.m_x; }
-    BigInt get_y() const { return m_coord.m_y; }
+    inline CurveContext const& get_curve() const { return m_curve; }
+    inline BigInt const& get_field() const { return m_curve->get_field(); }
+    inline BigInt const& get_a() const { return m_curve->get_a(); }
+    inline BigInt const& get_b() const { return m_curve->get_b(); }
+
+    BigInt const& get_x() const { return m_coord.m_x; }
+    BigInt const& get_y() const { return m_coord.m_y; }
 
     // The point at infinity is represented with homogeneous coordinate of w=0; and w=1 otherwise
     bool get_w() const { return m_coord.m_w; }
-    Coordinate get_coordinate() const { return m_coord; }
+    Coordinate const& get_coordinate() const { return m_coord; }
 
     Point& operator+=(Point const& rhs);
     Point& operator-=(Point const& rhs);
-    Point& operator*=(int64_t rhs);
+    Point& operator*=(BigInt const& rhs);
 
     Point operator+(Point const& rhs) const;
     Point operator-(Point const& rhs) const;
     Point operator-() const;
 
-    friend Point operator*(int64_t lhs, Point const& rhs);
-    friend Point operator*(Point const& lhs, int64_t rhs);
+    friend Point operator*(BigInt const& lhs, Point const& rhs);
+    friend Point operator*(Point const& lhs, BigInt const& rhs);
+
+#ifdef MONTGOMERY
+    static constexpr auto default_multiplication = ScalarMultiplication::Ladder;
+#else
+    static constexpr auto default_multiplication = ScalarMultiplication::WNAF;
+#endif
 
-    bool operator|=(Point const& rhs);
-    bool operator^=(Point const& rhs);
-    bool operator==(Point const& rhs);
-    bool operator!=(Point const& rhs);
+    Point multiply(BigInt const& scalar, ScalarMultiplication method = default_multiplication) const;
+
+    // Same curve; shared contexts compare by pointer, separately built ones by their parameters
+    bool operator|=(Point const& rhs) const;
+    bool operator^=(Point const& rhs) const;
+    bool operator==(Point const& rhs) const;
+    bool operator!=(Point const& rhs) const;
 
     friend std::ostream& operator<<(std::ostream& stream, Point const& point);
 };
 
-class EllipticCurve : public Curve {
+class JacobianPoint {
+    // Point in Jacobian coordinates, additions and doublings need no inversion. Chains of group operations
+    // are done in this representation, paying a single inversion in to_affine() at the end.
 private:
+    CurveContext m_curve;
+    JacobianCoordinate m_coord; // In field representation
+
+public:
+    JacobianPoint(CurveContext curve); // Point at infinity
+    JacobianPoint(Point const& point);
+
+    inline bool is_infinity() const { return m_coord.m_z.is_zero(); }
+    JacobianCoordinate const& get_coordinate() const { return m_coord; }
+
+    JacobianPoint& dbl();
+    JacobianPoint& operator+=(JacobianPoint const& rhs);
+    JacobianPoint& operator+=(Point const& rhs); // Mixed Jacobian-affine addition
+
+    // Mixed addition of an affine coordinate already in field representation
+    JacobianPoint& add_affine(Coordinate const& rhs);
+    JacobianPoint operator-() const;
+
+    static void cswap(JacobianPoint& lhs, JacobianPoint& rhs, bool swap);
+
+    Point to_affine() const;
+};
+
+class EllipticCurve {
+private:
+    CurveContext m_curve;
     std::vector<Point> m_points;
+    std::optional<BigInt> m_order;
 
     void generate_points();
 
 public:
-    EllipticCurve() { ASSERT_NOT_REACHED; }
-
     EllipticCurve(BigInt a, BigInt b, BigInt field)
-        : Curve(a, b, field)
+        : m_curve(Curve::make(a, b, field))
     {
     }
 
-    inline std::vector<Point> get_points()
+    inline CurveContext const& get_curve() const { return m_curve; }
+
+    // Affine points of the curve, the point at infinity excluded
+    inline std::vector<Point> const& get_points()
     {
         if (!m_points.size())
             generate_points();
 
         return m_points;
     };
+
+    // Number of points, the point at infinity included
+    BigInt get_order();
 };
+
+// Group order by baby-step giant-step on the curve and its quadratic twist (Mestre), O(p^(1/4)) group operations
+BigInt MestreOrder(CurveContext const& curve);
+
+// Group order by Schoof's algorithm, the trace of Frobenius modulo small primes l from the l-torsion
+BigInt SchoofOrder(CurveContext const& curve);
+
+// Width-w non-adjacent form of k > 0, least significant digit first
+std::vector<int8_t> wNAF(BigInt const& k, size_t w);
+
+// Sum of scalars[i] * points[i], Straus' interleaved wNAF for few terms and Pippenger's buckets for many
+Point MultiScalarMul(std::span<Point const> points, std::span<BigInt const> scalars, size_t threads = 0);
+
+// acc[i] += addend[i] over affine coordinates in field representation, sharing one inversion across the batch
+void BatchAdd(Curve const& curve, std::span<Coordinate> acc, std::span<Coordinate const> addend);
+std::vector<Point> BatchAdd(std::span<Point const> lhs, std::span<Point const> rhs);
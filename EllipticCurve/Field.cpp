@@ -0,0 +1,346 @@
+#include <EllipticCurve/Field.h>
+#include <Modmath.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+namespace {
+struct SolinasTerm {
+    // Words of the reduced value drawn from the 32-bit words c_i of the product, -1 for zero
+    int coefficient;
+    std::array<int8_t, 12> words;
+};
+
+// FIPS 186-4 D.2.3, p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+std::array<SolinasTerm, 8> constexpr p256_terms { {
+    { 2, { -1, -1, -1, 11, 12, 13, 14, 15 } },
+    { 2, { -1, -1, -1, 12, 13, 14, 15, -1 } },
+    { 1, { 8, 9, 10, -1, -1, -1, 14, 15 } },
+    { 1, { 9, 10, 11, 13, 14, 15, 13, 8 } },
+    { -1, { 11, 12, 13, -1, -1, -1, 8, 10 } },
+    { -1, { 12, 13, 14, 15, -1, -1, 9, 11 } },
+    { -1, { 13, 14, 15, 8, 9, 10, -1, 12 } },
+    { -1, { 14, 15, -1, 9, 10, 11, -1, 13 } },
+} };
+
+// FIPS 186-4 D.2.4, p = 2^384 - 2^128 - 2^96 + 2^32 - 1
+std::array<SolinasTerm, 9> constexpr p384_terms { {
+    { 2, { -1, -1, -1, -1, 21, 22, 23, -1, -1, -1, -1, -1 } },
+    { 1, { 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23 } },
+    { 1, { 21, 22, 23, 12, 13, 14, 15, 16, 17, 18, 19, 20 } },
+    { 1, { -1, 23, -1, 20, 12, 13, 14, 15, 16, 17, 18, 19 } },
+    { 1, { -1, -1, -1, -1, 20, 21, 22, 23, -1, -1, -1, -1 } },
+    { 1, { 20, -1, -1, 21, 22, 23, -1, -1, -1, -1, -1, -1 } },
+    { -1, { 23, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22 } },
+    { -1, { -1, 20, 21, 22, 23, -1, -1, -1, -1, -1, -1, -1 } },
+    { -1, { -1, -1, -1, 23, 23, -1, -1, -1, -1, -1, -1, -1 } },
+} };
+
+BigInt Power(int bits) { return BigInt { 1 } << bits; }
+}
+
+Field::Field(BigInt modulus)
+    : m_modulus(std::move(modulus))
+    , m_limbs(m_modulus.get_groups().begin(), m_modulus.get_groups().end())
+    , m_reduction(m_modulus.bit_at(0) ? Reduction::Montgomery : Reduction::Division)
+{
+    if (m_modulus == Power(256) - Power(32) - 977)
+        m_reduction = Reduction::Secp256k1;
+    else if (m_modulus == Power(256) - Power(224) + Power(192) + Power(96) - 1)
+        m_reduction = Reduction::P256;
+    else if (m_modulus == Power(384) - Power(128) - Power(96) + Power(32) - 1)
+        m_reduction = Reduction::P384;
+    else if (m_modulus == Power(255) - 19)
+        m_reduction = Reduction::Curve25519;
+
+    if (m_reduction != Reduction::Montgomery) {
+        m_one = BigInt { 1 } % m_modulus;
+        return;
+    }
+
+    // Newton iteration for p^-1 mod 2^32, each step doubles the number of correct bits
+    auto inverse = m_limbs[0];
+
+    for (auto i = 0; i < 4; i++)
+        inverse *= 2 - m_limbs[0] * inverse;
+
+    m_inverse = -inverse;
+
+    auto const bits = static_cast<int>(32 * m_limbs.size());
+
+    m_one = (BigInt { 1 } << bits) % m_modulus;
+    m_r2 = (BigInt { 1 } << (2 * bits)) % m_modulus;
+}
+
+BigInt Field::reduce(std::vector<uint32_t>& t) const
+{
+    // t holds T < pR in 2n + 1 groups, returns TR^-1 mod p
+    auto const n = m_limbs.size();
+
+    for (auto i = 0uz; i < n; i++) {
+        auto const m = static_cast<uint64_t>(t[i] * m_inverse);
+        auto carry = uint64_t {};
+
+        for (auto j = 0uz; j < n; j++) {
+            auto const sum = t[i + j] + m * m_limbs[j] + carry;
+
+            t[i + j] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+
+        for (auto j = i + n; carry; j++) {
+            auto const sum = t[j] + carry;
+
+            t[j] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+    }
+
+    auto result = BigInt { std::deque<uint32_t>(t.begin() + static_cast<ptrdiff_t>(n), t.end()) };
+
+    if (result >= m_modulus)
+        result -= m_modulus;
+
+    return result;
+}
+
+BigInt Field::reduce_special(std::vector<uint32_t> const& t) const
+{
+    // t is the 2n-word product of two residues. Reduce it to n words and a signed top word, then
+    // bring the top word to zero and the words below p with a few additions or subtractions of p.
+    auto const n = m_limbs.size();
+    auto acc = std::array<int64_t, 13> {};
+
+    auto const carry = [&] {
+        for (auto i = 0uz; i < n; i++) {
+            acc[i + 1] += acc[i] >> 32;
+            acc[i] &= 0xffffffff;
+        }
+    };
+
+    auto const solinas = [&](auto const& terms) {
+        for (auto i = 0uz; i < n; i++)
+            acc[i] = t[i];
+
+        for (auto const& term : terms) {
+            for (auto i = 0uz; i < n; i++) {
+                if (term.words[i] >= 0)
+                    acc[i] += term.coefficient * static_cast<int64_t>(t[static_cast<size_t>(term.words[i])]);
+            }
+        }
+
+        carry();
+    };
+
+    switch (m_reduction) {
+    case Reduction::Secp256k1: {
+        // 2^256 = 2^32 + 977, folded twice
+        for (auto i = 0uz; i < 8; i++) {
+            acc[i] += t[i] + 977 * static_cast<int64_t>(t[i + 8]);
+            acc[i + 1] += t[i + 8];
+        }
+
+        carry();
+
+        auto const top = std::exchange(acc[8], 0);
+
+        acc[0] += 977 * top;
+        acc[1] += top;
+        carry();
+        break;
+    }
+    case Reduction::Curve25519: {
+        // 2^256 = 38, folded twice
+        for (auto i = 0uz; i < 8; i++)
+            acc[i] = t[i] + 38 * static_cast<int64_t>(t[i + 8]);
+
+        carry();
+
+        acc[0] += 38 * std::exchange(acc[8], 0);
+        carry();
+        break;
+    }
+    case Reduction::P256:
+        solinas(p256_terms);
+        break;
+    case Reduction::P384:
+        solinas(p384_terms);
+        break;
+    default:
+        assert(false);
+    }
+
+    auto const adjust = [&](int64_t sign) {
+        for (auto i = 0uz; i < n; i++)
+            acc[i] += sign * static_cast<int64_t>(m_limbs[i]);
+
+        carry();
+    };
+
+    while (acc[n] < 0)
+        adjust(1);
+
+    while (acc[n] > 0)
+        adjust(-1);
+
+    auto result = BigInt { std::deque<uint32_t>(acc.begin(), acc.begin() + static_cast<ptrdiff_t>(n)) };
+
+    while (result >= m_modulus)
+        result -= m_modulus;
+
+    return result;
+}
+
+BigInt Field::to(BigInt const& x) const
+{
+    auto const residue = x % m_modulus;
+
+    if (m_reduction != Reduction::Montgomery)
+        return residue;
+
+    return mul(residue, m_r2);
+}
+
+BigInt Field::from(BigInt const& x) const
+{
+    if (m_reduction != Reduction::Montgomery)
+        return x;
+
+    auto t = std::vector<uint32_t>(2 * m_limbs.size() + 1);
+    std::copy(x.get_groups().begin(), x.get_groups().end(), t.begin());
+
+    return reduce(t);
+}
+
+BigInt Field::add(BigInt const& lhs, BigInt const& rhs) const
+{
+    auto result = lhs + rhs;
+
+    if (result >= m_modulus)
+        result -= m_modulus;
+
+    return result;
+}
+
+BigInt Field::sub(BigInt const& lhs, BigInt const& rhs) const
+{
+    auto result = lhs - rhs;
+
+    if (result.is_negative())
+        result += m_modulus;
+
+    return result;
+}
+
+BigInt Field::neg(BigInt const& x) const
+{
+    if (x.is_zero())
+        return x;
+
+    return m_modulus - x;
+}
+
+BigInt Field::mul(BigInt const& lhs, BigInt const& rhs) const
+{
+    if (m_reduction == Reduction::Division)
+        return (lhs * rhs) % m_modulus;
+
+    // Schoolbook product into 2n + 1 groups, then a single Montgomery or special form reduction
+    auto const n = m_limbs.size();
+    auto const& a = lhs.get_groups();
+    auto const& b = rhs.get_groups();
+
+    auto t = std::vector<uint32_t>(2 * n + 1);
+
+    for (auto i = 0uz; i < a.size(); i++) {
+        auto const ai = static_cast<uint64_t>(a[i]);
+        auto carry = uint64_t {};
+
+        if (!ai)
+            continue;
+
+        for (auto j = 0uz; j < b.size(); j++) {
+            auto const sum = t[i + j] + ai * b[j] + carry;
+
+            t[i + j] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+
+        t[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+
+    if (m_reduction != Reduction::Montgomery)
+        return reduce_special(t);
+
+    return reduce(t);
+}
+
+BigInt Field::sqr(BigInt const& x) const { return mul(x, x); }
+
+BigInt Field::inv(BigInt const& x) const
+{
+    // (xR)^-1 R = x^-1 R^2 R^-1, so invert the canonical value and convert back
+    return to(Modinv(from(x), m_modulus));
+}
+
+BigInt Field::pow(BigInt const& x, BigInt const& exponent) const
+{
+    auto result = m_one;
+
+    for (auto i = exponent.size(); i-- > 0;) {
+        result = sqr(result);
+
+        if (exponent.bit_at(i))
+            result = mul(result, x);
+    }
+
+    return result;
+}
+
+std::optional<BigInt> Field::sqrt(BigInt const& x) const
+{
+    if (m_modulus.bit_at(0) && m_modulus.bit_at(1)) {
+        // x^((p + 1) / 4) squares to x^((p - 1) / 2) x, which is x exactly when x is a square
+        auto root = pow(x, (m_modulus + 1) >> 2);
+
+        if (sqr(root) != x)
+            return {};
+
+        return root;
+    }
+
+    auto const root = Modsqrt(from(x), m_modulus);
+
+    if (!root)
+        return {};
+
+    return to(*root);
+}
+
+void Field::cswap(BigInt& lhs, BigInt& rhs, bool swap) const
+{
+    // Both are widened to the groups of p, so the copies and the masked exchange depend on the modulus alone
+    auto const mask = -static_cast<uint32_t>(swap);
+    auto const size = m_limbs.size();
+
+    assert(lhs.groups() <= size && rhs.groups() <= size);
+
+    auto a = std::deque<uint32_t>(size);
+    auto b = std::deque<uint32_t>(size);
+
+    std::ranges::copy(lhs.get_groups(), a.begin());
+    std::ranges::copy(rhs.get_groups(), b.begin());
+
+    for (auto i = 0uz; i < size; i++) {
+        auto const t = (a[i] ^ b[i]) & mask;
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+
+    lhs = BigInt { std::move(a) };
+    rhs = BigInt { std::move(b) };
+}
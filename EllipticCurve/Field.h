@@ -0,0 +1,70 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class Field {
+    /**
+     * Arithmetic modulo the prime of a curve
+     * Elements are kept in Montgomery form xR mod p with R = 2^(32n), n the number of groups in p, so that
+     * products are reduced with word-sized multiplications (CIOS) instead of a long division.
+     * The primes of the standard curves have dedicated fixed-width reductions instead, working on plain
+     * residues: folding for 2^256 - 2^32 - 977 and 2^255 - 19, and Solinas' word tables for P-256 and P-384.
+     * An even modulus has no Montgomery form, and then elements are plain residues reduced with %.
+     * Elements are BigInts here whatever the reduction, allocated and variable-length. For those four primes
+     * FixedField has fixed-limb elements on the stack, and Point::multiply and X25519 run on it; additions,
+     * multi-scalar multiplication, BatchAdd and FixedBaseTable still work on this BigInt representation.
+     */
+public:
+    using Element = BigInt;
+
+    enum class Reduction {
+        Division,
+        Montgomery,
+        Secp256k1,
+        P256,
+        P384,
+        Curve25519,
+    };
+
+private:
+    BigInt m_modulus;
+    std::vector<uint32_t> m_limbs;
+    Reduction m_reduction;
+    uint32_t m_inverse { 0 }; // -p^-1 mod 2^32
+    BigInt m_one;             // R mod p
+    BigInt m_r2;              // R^2 mod p
+
+    BigInt reduce(std::vector<uint32_t>& t) const;
+    BigInt reduce_special(std::vector<uint32_t> const& t) const;
+
+public:
+    Field(BigInt modulus);
+
+    inline BigInt const& get_modulus() const { return m_modulus; }
+    inline BigInt const& one() const { return m_one; }
+    inline BigInt zero() const { return BigInt {}; }
+    inline bool is_zero(BigInt const& x) const { return x.is_zero(); }
+    inline Reduction get_reduction() const { return m_reduction; }
+
+    BigInt to(BigInt const& x) const;   // Canonical residue to field representation
+    BigInt from(BigInt const& x) const; // Field representation to canonical residue in [0, p)
+
+    BigInt add(BigInt const& lhs, BigInt const& rhs) const;
+    BigInt sub(BigInt const& lhs, BigInt const& rhs) const;
+    BigInt neg(BigInt const& x) const;
+    BigInt mul(BigInt const& lhs, BigInt const& rhs) const;
+    BigInt sqr(BigInt const& x) const;
+    BigInt inv(BigInt const& x) const;
+    BigInt pow(BigInt const& x, BigInt const& exponent) const;
+
+    // A square root of x, none if x is not a square. A single exponentiation when p = 3 mod 4.
+    std::optional<BigInt> sqrt(BigInt const& x) const;
+
+    // Exchanges lhs and rhs when swap is set, over the width of p either way. Only the exchange is masked:
+    // BigInt arithmetic itself takes time that depends on the values, for constant time see FixedField.
+    void cswap(BigInt& lhs, BigInt& rhs, bool swap) const;
+};
@@ -0,0 +1,347 @@
+#include <EllipticCurve/FixedBaseTable.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+
+namespace {
+void write(std::ofstream& file, uint64_t value)
+{
+    file.write(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+void write(std::ofstream& file, BigInt const& value)
+{
+    auto const& groups = value.get_groups();
+    auto const buffer = std::vector<uint32_t>(groups.begin(), groups.end());
+
+    write(file, static_cast<uint64_t>(value.is_negative()));
+    write(file, static_cast<uint64_t>(buffer.size()));
+    file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(uint32_t)));
+}
+
+uint64_t read(std::ifstream& file)
+{
+    auto value = uint64_t {};
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+
+    return value;
+}
+
+BigInt read_bigint(std::ifstream& file)
+{
+    auto const negative = read(file);
+    auto const size = read(file);
+
+    if (!file || size == 0 || size > (1uz << 20))
+        throw new std::runtime_error("[FixedBaseTable] Malformed table file");
+
+    auto buffer = std::vector<uint32_t>(size);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+
+    auto value = BigInt { std::deque<uint32_t>(buffer.begin(), buffer.end()) };
+
+    return negative ? -value : value;
+}
+
+template <typename F>
+void convert(std::vector<uint32_t>& table, size_t limbs, F&& f)
+{
+    // Maps both coordinates of every finite entry through f, files hold canonical residues
+    auto const stride = 1 + 2 * limbs;
+
+    for (auto entry = table.begin(); entry != table.end(); entry += static_cast<ptrdiff_t>(stride)) {
+        if (!entry[0])
+            continue;
+
+        for (auto coordinate = entry + 1; coordinate != entry + static_cast<ptrdiff_t>(stride); coordinate += static_cast<ptrdiff_t>(limbs)) {
+            auto const value = f(BigInt { std::deque<uint32_t>(coordinate, coordinate + static_cast<ptrdiff_t>(limbs)) });
+
+            std::fill(coordinate, coordinate + static_cast<ptrdiff_t>(limbs), 0);
+            std::copy(value.get_groups().begin(), value.get_groups().end(), coordinate);
+        }
+    }
+}
+
+std::vector<Coordinate> Normalize(Field const& F, std::span<JacobianPoint const> points)
+{
+    // to_affine() of every point, in field representation, with one inversion shared by Montgomery's trick.
+    // Infinity stands in as 1 in the running products and comes out with w = 0.
+    auto prefix = std::vector<BigInt>(points.size());
+    auto product = F.one();
+
+    for (auto i = 0uz; i < points.size(); i++) {
+        if (!points[i].is_infinity())
+            product = F.mul(product, points[i].get_coordinate().m_z);
+
+        prefix[i] = product;
+    }
+
+    auto affine = std::vector<Coordinate>(points.size(), Coordinate { 0, 0, 0 });
+    auto inverse = F.inv(product);
+
+    for (auto i = points.size(); i-- > 0;) {
+        if (points[i].is_infinity())
+            continue;
+
+        auto const& [X, Y, Z] = points[i].get_coordinate();
+        auto const zinv = i ? F.mul(inverse, prefix[i - 1]) : inverse;
+        auto const zinv2 = F.sqr(zinv);
+
+        inverse = F.mul(inverse, Z);
+        affine[i] = Coordinate { F.mul(X, zinv2), F.mul(Y, F.mul(zinv2, zinv)) };
+    }
+
+    return affine;
+}
+
+uint64_t constexpr magic = 0x31544246; // "FBT1"
+}
+
+FixedBaseTable::FixedBaseTable(Point base, size_t window, size_t rows, size_t limbs, std::vector<uint32_t> table)
+    : m_base(std::move(base))
+    , m_window(window)
+    , m_rows(rows)
+    , m_limbs(limbs)
+    , m_table(std::move(table))
+{
+}
+
+FixedBaseTable::FixedBaseTable(Point const& base, size_t window)
+    : m_base(base)
+    , m_window(window)
+    , m_rows(0)
+    , m_limbs(base.get_field().groups())
+{
+    if (window == 0 || window > 8)
+        throw new std::runtime_error("[FixedBaseTable] Window must be between 1 and 8 bits");
+
+    // Scalars up to the group order, which may exceed the field size by a bit
+    m_rows = (base.get_field().size() + 1 + window - 1) / window;
+
+    auto const entries = 1uz << m_window;
+    auto const stride = 1 + 2 * m_limbs;
+
+    m_table.assign(m_rows * entries * stride, 0);
+
+    // Entries are kept in field representation, ready for mixed addition
+    auto const& curve = base.get_curve();
+    auto const& F = curve->get_arithmetic();
+
+    auto const store = [&](size_t row, size_t digit, Coordinate const& point) {
+        auto* entry = m_table.data() + (row * entries + digit) * stride;
+
+        if (point.m_w == 0)
+            return;
+
+        entry[0] = 1;
+        std::copy(point.m_x.get_groups().begin(), point.m_x.get_groups().end(), entry + 1);
+        std::copy(point.m_y.get_groups().begin(), point.m_y.get_groups().end(), entry + 1 + m_limbs);
+    };
+
+    // Each row is built in Jacobian coordinates by mixed additions of its affine base, with 2^w times the
+    // base at the end for the next row, and the whole row is then normalized with a single inversion
+    auto row_base = Coordinate { F.to(base.get_x()), F.to(base.get_y()) };
+
+    for (auto row = 0uz; row < m_rows; row++) {
+        auto multiples = std::vector<JacobianPoint>(entries + 1, JacobianPoint { curve });
+
+        for (auto digit = 1uz; digit <= entries; digit++)
+            (multiples[digit] = multiples[digit - 1]).add_affine(row_base);
+
+        auto const affine = Normalize(F, multiples);
+
+        for (auto digit = 1uz; digit < entries; digit++)
+            store(row, digit, affine[digit]);
+
+        row_base = affine[entries];
+    }
+}
+
+Coordinate FixedBaseTable::at(size_t row, size_t digit) const
+{
+    auto const stride = 1 + 2 * m_limbs;
+    auto const entry = m_table.begin() + static_cast<ptrdiff_t>((row * (1uz << m_window) + digit) * stride);
+
+    return Coordinate {
+        BigInt { std::deque<uint32_t>(entry + 1, entry + 1 + static_cast<ptrdiff_t>(m_limbs)) },
+        BigInt { std::deque<uint32_t>(entry + 1 + static_cast<ptrdiff_t>(m_limbs), entry + static_cast<ptrdiff_t>(stride)) },
+        entry[0] != 0
+    };
+}
+
+bool FixedBaseTable::verify() const
+{
+    // Entry 0 of every row is infinity, entry 1 of row 0 is the base, and every other entry is its predecessor
+    // plus entry 1 of its row, entry 1 of a row following from the last entry of the row before. Checking all
+    // these sums at once with BatchAdd proves every entry by induction, for one inversion in total.
+    auto const& curve = m_base.get_curve();
+    auto const& F = curve->get_arithmetic();
+    auto const entries = 1uz << m_window;
+
+    auto const first = at(0, 1);
+
+    if (!first.m_w || first.m_x != F.to(m_base.get_x()) || first.m_y != F.to(m_base.get_y()))
+        return false;
+
+    auto acc = std::vector<Coordinate> {};
+    auto addend = std::vector<Coordinate> {};
+    auto expected = std::vector<Coordinate> {};
+
+    for (auto row = 0uz; row < m_rows; row++) {
+        if (at(row, 0).m_w)
+            return false;
+
+        auto const step = at(row, 1);
+
+        for (auto digit = 2uz; digit <= entries; digit++) {
+            if (digit == entries && row + 1 == m_rows)
+                break;
+
+            acc.push_back(at(row, digit - 1));
+            addend.push_back(step);
+            expected.push_back(digit == entries ? at(row + 1, 1) : at(row, digit));
+        }
+    }
+
+    BatchAdd(*curve, acc, addend);
+
+    for (auto i = 0uz; i < acc.size(); i++) {
+        if (acc[i].m_w != expected[i].m_w)
+            return false;
+
+        if (acc[i].m_w && (acc[i].m_x != expected[i].m_x || acc[i].m_y != expected[i].m_y))
+            return false;
+    }
+
+    return true;
+}
+
+Coordinate FixedBaseTable::lookup(size_t row, uint32_t digit) const
+{
+    // Every entry of the row is read, the selected one survives the mask
+    auto const entries = 1uz << m_window;
+    auto const stride = 1 + 2 * m_limbs;
+    auto const* entry = m_table.data() + row * entries * stride;
+
+    auto selected = std::vector<uint32_t>(stride);
+
+    for (auto e = 0uz; e < entries; e++, entry += stride) {
+        auto const mask = -static_cast<uint32_t>(e == digit);
+
+        for (auto i = 0uz; i < stride; i++)
+            selected[i] |= entry[i] & mask;
+    }
+
+    return Coordinate {
+        BigInt { std::deque<uint32_t>(selected.begin() + 1, selected.begin() + 1 + static_cast<ptrdiff_t>(m_limbs)) },
+        BigInt { std::deque<uint32_t>(selected.begin() + 1 + static_cast<ptrdiff_t>(m_limbs), selected.end()) },
+        selected[0] != 0
+    };
+}
+
+Point FixedBaseTable::multiply(BigInt const& scalar) const
+{
+    auto const k = scalar.abs();
+
+    // Scalars past the table fall back to variable-base multiplication
+    if (k.size() > m_rows * m_window)
+        return m_base.multiply(scalar);
+
+    auto R = JacobianPoint { m_base.get_curve() };
+
+    for (auto row = 0uz; row < m_rows; row++) {
+        auto digit = 0u;
+
+        for (auto i = 0uz; i < m_window; i++)
+            digit |= static_cast<unsigned>(k.bit_at(row * m_window + i)) << i;
+
+        R.add_affine(lookup(row, digit));
+    }
+
+    auto const result = R.to_affine();
+
+    return scalar.is_negative() ? -result : result;
+}
+
+void FixedBaseTable::save(std::filesystem::path const& path) const
+{
+    auto file = std::ofstream { path, std::ios::binary | std::ios::trunc };
+
+    if (!file)
+        throw new std::runtime_error("[FixedBaseTable] Unable to open table file");
+
+    write(file, magic);
+    write(file, m_window);
+    write(file, m_rows);
+    write(file, m_limbs);
+
+    write(file, m_base.get_field());
+    write(file, m_base.get_a());
+    write(file, m_base.get_b());
+    write(file, m_base.get_x());
+    write(file, m_base.get_y());
+
+    auto const& F = m_base.get_curve()->get_arithmetic();
+    auto table = m_table;
+
+    convert(table, m_limbs, [&F](BigInt const& x) { return F.from(x); });
+
+    write(file, table.size());
+    file.write(reinterpret_cast<char const*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(uint32_t)));
+
+    if (!file)
+        throw new std::runtime_error("[FixedBaseTable] Unable to write table file");
+}
+
+FixedBaseTable FixedBaseTable::load(std::filesystem::path const& path, CurveContext const& curve)
+{
+    auto file = std::ifstream { path, std::ios::binary };
+
+    if (!file)
+        throw new std::runtime_error("[FixedBaseTable] Unable to open table file");
+
+    if (read(file) != magic)
+        throw new std::runtime_error("[FixedBaseTable] Malformed table file");
+
+    auto const window = read(file);
+    auto const rows = read(file);
+    auto const limbs = read(file);
+
+    auto const field = read_bigint(file);
+    auto const a = read_bigint(file);
+    auto const b = read_bigint(file);
+    auto const x = read_bigint(file);
+    auto const y = read_bigint(file);
+
+    auto const size = read(file);
+
+    if (!file || window == 0 || window > 8 || limbs != field.groups() || size != rows * (1uz << window) * (1 + 2 * limbs))
+        throw new std::runtime_error("[FixedBaseTable] Malformed table file");
+
+    if (field != curve->get_field() || a != curve->get_a() || b != curve->get_b())
+        throw new std::runtime_error("[FixedBaseTable] Table is for another curve");
+
+    if (rows != (field.size() + window) / window)
+        throw new std::runtime_error("[FixedBaseTable] Malformed table file");
+
+    auto table = std::vector<uint32_t>(size);
+    file.read(reinterpret_cast<char*>(table.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+
+    if (!file)
+        throw new std::runtime_error("[FixedBaseTable] Malformed table file");
+
+    auto base = Point { x, y, curve };
+    auto const& F = curve->get_arithmetic();
+
+    convert(table, limbs, [&F](BigInt const& x) { return F.to(x); });
+
+    auto result = FixedBaseTable { std::move(base), window, rows, limbs, std::move(table) };
+
+    if (!result.verify())
+        throw new std::runtime_error("[FixedBaseTable] Table entries are not multiples of the base point");
+
+    return result;
+}
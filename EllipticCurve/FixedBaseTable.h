@@ -0,0 +1,44 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class FixedBaseTable {
+    /**
+     * Precomputed 2^w-ary table for multiplication of a fixed base point G
+     * Row j holds d * 2^(wj) * G for every w-bit digit d, in affine coordinates. A scalar k with digits k_j
+     * is then k * G = sum_j T[j][k_j], one mixed addition per digit and no doublings at all.
+     * Lookups read every entry of a row and select the wanted one with a mask.
+     */
+private:
+    Point m_base;
+    size_t m_window;
+    size_t m_rows;
+    size_t m_limbs;                // 32-bit limbs per coordinate
+    std::vector<uint32_t> m_table; // rows x 2^w entries x (x, y) x limbs, entry 0 of a row is infinity
+
+    FixedBaseTable(Point base, size_t window, size_t rows, size_t limbs, std::vector<uint32_t> table);
+
+    Coordinate lookup(size_t row, uint32_t digit) const;
+    Coordinate at(size_t row, size_t digit) const; // Direct read, for public data only
+
+    bool verify() const;
+
+public:
+    FixedBaseTable(Point const& base, size_t window = 4);
+
+    inline Point const& get_base() const { return m_base; }
+    inline size_t get_window() const { return m_window; }
+
+    Point multiply(BigInt const& scalar) const;
+
+    void save(std::filesystem::path const& path) const;
+
+    // A table saved for a base on this curve. Throws for a file of another curve, and for entries that are
+    // not the multiples of the base they stand for, which are all checked at about the cost of building them.
+    static FixedBaseTable load(std::filesystem::path const& path, CurveContext const& curve);
+};
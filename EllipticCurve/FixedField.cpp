@@ -0,0 +1,33 @@
+#include <EllipticCurve/FixedField.h>
+
+namespace {
+BigInt Power(int bits) { return BigInt { 1 } << bits; }
+}
+
+FixedField<4, FixedReduction::Fold> const& Secp256k1Field()
+{
+    auto static const field = FixedField<4, FixedReduction::Fold> { Power(256) - Power(32) - 977 };
+
+    return field;
+}
+
+FixedField<4, FixedReduction::Montgomery> const& P256Field()
+{
+    auto static const field = FixedField<4, FixedReduction::Montgomery> { Power(256) - Power(224) + Power(192) + Power(96) - 1 };
+
+    return field;
+}
+
+FixedField<6, FixedReduction::Montgomery> const& P384Field()
+{
+    auto static const field = FixedField<6, FixedReduction::Montgomery> { Power(384) - Power(128) - Power(96) + Power(32) - 1 };
+
+    return field;
+}
+
+FixedField<4, FixedReduction::Fold> const& Curve25519Field()
+{
+    auto static const field = FixedField<4, FixedReduction::Fold> { Power(255) - 19 };
+
+    return field;
+}
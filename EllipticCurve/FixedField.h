@@ -0,0 +1,331 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/Field.h>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+enum class FixedReduction {
+    // Montgomery multiplication, elements held as xR mod p with R = 2^(64N)
+    Montgomery,
+    // For p just below 2^(64N): the high half of a product is folded into the low half times c = 2^(64N) mod p
+    Fold,
+};
+
+template<size_t N, FixedReduction Reduction>
+class FixedField {
+    /**
+     * Arithmetic modulo a prime of at most 64N bits, on elements of N 64-bit limbs that live on the stack
+     * Elements are always fully reduced, and no branch or memory access depends on their values: carries are
+     * propagated arithmetically and conditional subtractions and exchanges are masks. Only the modulus, which
+     * is public, steers the flow, and inversion is by Fermat's little theorem for the same reason.
+     * The interface mirrors Field, so the curve formulas are written once for both.
+     */
+public:
+    using Element = std::array<uint64_t, N>;
+
+private:
+    __extension__ using Wide = unsigned __int128;
+
+    BigInt m_prime;
+    Element m_modulus;
+    Element m_exponent;       // p - 2, for inversion
+    uint64_t m_inverse { 0 }; // -p^-1 mod 2^64, Montgomery
+    uint64_t m_fold { 0 };    // 2^(64N) mod p, Fold
+    Element m_one {};         // 1 in field representation
+    Element m_r2 {};          // R^2 mod p, Montgomery
+
+    static inline Element Limbs(BigInt const& x)
+    {
+        auto limbs = Element {};
+        auto const& groups = x.get_groups();
+
+        for (auto i = 0uz; i < groups.size() && i < 2 * N; i++)
+            limbs[i / 2] |= static_cast<uint64_t>(groups[i]) << (32 * (i % 2));
+
+        return limbs;
+    }
+
+    static inline uint64_t AddCarry(uint64_t lhs, uint64_t rhs, uint64_t& carry)
+    {
+        auto const sum = Wide { lhs } + rhs + carry;
+
+        carry = static_cast<uint64_t>(sum >> 64);
+        return static_cast<uint64_t>(sum);
+    }
+
+    static inline uint64_t SubBorrow(uint64_t lhs, uint64_t rhs, uint64_t& borrow)
+    {
+        auto const difference = Wide { lhs } - rhs - borrow;
+
+        borrow = static_cast<uint64_t>(difference >> 64) & 1;
+        return static_cast<uint64_t>(difference);
+    }
+
+    inline void reduce_once(Element& x, uint64_t carry) const
+    {
+        // x + carry 2^(64N) < 2p into [0, p): subtract p unless that borrows past the carry
+        auto borrow = uint64_t {};
+        auto difference = Element {};
+
+        for (auto i = 0uz; i < N; i++)
+            difference[i] = SubBorrow(x[i], m_modulus[i], borrow);
+
+        auto const mask = -(carry | (borrow ^ 1));
+
+        for (auto i = 0uz; i < N; i++)
+            x[i] ^= (x[i] ^ difference[i]) & mask;
+    }
+
+    inline Element montgomery(Element const& lhs, Element const& rhs) const
+    {
+        // CIOS: one row of the product and one reduction step per limb of rhs, the result below 2p
+        auto t = Element {};
+        auto top = uint64_t {};
+
+        for (auto i = 0uz; i < N; i++) {
+            auto carry = uint64_t {};
+
+            for (auto j = 0uz; j < N; j++) {
+                auto const sum = Wide { lhs[j] } * rhs[i] + t[j] + carry;
+
+                t[j] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+            }
+
+            // The row ends in two words above t, top and overflow
+            auto overflow = uint64_t {};
+            top = AddCarry(top, carry, overflow);
+
+            auto const m = t[0] * m_inverse;
+            carry = static_cast<uint64_t>((Wide { m } * m_modulus[0] + t[0]) >> 64);
+
+            for (auto j = 1uz; j < N; j++) {
+                auto const sum = Wide { m } * m_modulus[j] + t[j] + carry;
+
+                t[j - 1] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+            }
+
+            auto shifted = uint64_t {};
+            t[N - 1] = AddCarry(top, carry, shifted);
+            top = overflow + shifted;
+        }
+
+        reduce_once(t, top);
+
+        return t;
+    }
+
+    inline Element fold(Element const& lhs, Element const& rhs) const
+    {
+        // The 2N-limb product is low + high 2^(64N) = low + high c. The first fold leaves a carry below c + 1,
+        // folding that back may carry once more, and the third fold cannot. What remains is below 2^(64N) < 3p.
+        auto product = std::array<uint64_t, 2 * N> {};
+
+        for (auto i = 0uz; i < N; i++) {
+            auto carry = uint64_t {};
+
+            for (auto j = 0uz; j < N; j++) {
+                auto const sum = Wide { lhs[i] } * rhs[j] + product[i + j] + carry;
+
+                product[i + j] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+            }
+
+            product[i + N] = carry;
+        }
+
+        auto result = Element {};
+        auto carry = Wide {};
+
+        for (auto i = 0uz; i < N; i++) {
+            auto const sum = Wide { product[i + N] } * m_fold + product[i] + carry;
+
+            result[i] = static_cast<uint64_t>(sum);
+            carry = sum >> 64;
+        }
+
+        for (auto round = 0; round < 2; round++) {
+            carry *= m_fold;
+
+            for (auto i = 0uz; i < N; i++) {
+                auto const sum = Wide { result[i] } + carry;
+
+                result[i] = static_cast<uint64_t>(sum);
+                carry = sum >> 64;
+            }
+        }
+
+        reduce_once(result, 0);
+        reduce_once(result, 0);
+
+        return result;
+    }
+
+public:
+    FixedField(BigInt const& modulus)
+        : m_prime(modulus)
+        , m_modulus(Limbs(modulus))
+        , m_exponent(Limbs(modulus - 2))
+    {
+        auto const R = BigInt { 1 } << static_cast<int>(64 * N);
+
+        assert(modulus.bit_at(0) && modulus < R && modulus * 3 > R);
+
+        if constexpr (Reduction == FixedReduction::Montgomery) {
+            // Newton iteration for p^-1 mod 2^64, each step doubles the number of correct bits from 3
+            auto inverse = m_modulus[0];
+
+            for (auto i = 0; i < 5; i++)
+                inverse *= 2 - m_modulus[0] * inverse;
+
+            m_inverse = -inverse;
+            m_one = Limbs(R % modulus);
+            m_r2 = Limbs(R * R % modulus);
+        } else {
+            m_fold = (R % modulus).to_uint64();
+            m_one[0] = 1;
+
+            assert(m_fold < uint64_t { 1 } << 62);
+        }
+    }
+
+    inline BigInt const& get_modulus() const { return m_prime; }
+    inline Element const& one() const { return m_one; }
+    inline Element zero() const { return Element {}; }
+
+    Element to(BigInt const& x) const
+    {
+        auto const limbs = Limbs(x % m_prime);
+
+        if constexpr (Reduction == FixedReduction::Montgomery)
+            return montgomery(limbs, m_r2);
+        else
+            return limbs;
+    }
+
+    BigInt from(Element const& x) const
+    {
+        auto canonical = x;
+
+        if constexpr (Reduction == FixedReduction::Montgomery)
+            canonical = montgomery(x, Element { 1 });
+
+        auto groups = std::deque<uint32_t>(2 * N);
+
+        for (auto i = 0uz; i < 2 * N; i++)
+            groups[i] = static_cast<uint32_t>(canonical[i / 2] >> (32 * (i % 2)));
+
+        return BigInt { std::move(groups) };
+    }
+
+    inline Element add(Element const& lhs, Element const& rhs) const
+    {
+        auto result = Element {};
+        auto carry = uint64_t {};
+
+        for (auto i = 0uz; i < N; i++)
+            result[i] = AddCarry(lhs[i], rhs[i], carry);
+
+        reduce_once(result, carry);
+
+        return result;
+    }
+
+    inline Element sub(Element const& lhs, Element const& rhs) const
+    {
+        // A borrow out means the difference wrapped, and p is added back under its mask
+        auto result = Element {};
+        auto borrow = uint64_t {};
+
+        for (auto i = 0uz; i < N; i++)
+            result[i] = SubBorrow(lhs[i], rhs[i], borrow);
+
+        auto const mask = -borrow;
+        auto carry = uint64_t {};
+
+        for (auto i = 0uz; i < N; i++)
+            result[i] = AddCarry(result[i], m_modulus[i] & mask, carry);
+
+        return result;
+    }
+
+    inline Element neg(Element const& x) const { return sub(Element {}, x); }
+
+    inline Element mul(Element const& lhs, Element const& rhs) const
+    {
+        if constexpr (Reduction == FixedReduction::Montgomery)
+            return montgomery(lhs, rhs);
+        else
+            return fold(lhs, rhs);
+    }
+
+    inline Element sqr(Element const& x) const { return mul(x, x); }
+
+    Element inv(Element const& x) const
+    {
+        // x^(p - 2), square and multiply over the bits of the public exponent. The inverse of 0 is 0.
+        auto result = m_one;
+
+        for (auto i = 64 * N; i-- > 0;) {
+            result = sqr(result);
+
+            if (m_exponent[i / 64] >> (i % 64) & 1)
+                result = mul(result, x);
+        }
+
+        return result;
+    }
+
+    inline bool is_zero(Element const& x) const
+    {
+        auto bits = uint64_t {};
+
+        for (auto limb : x)
+            bits |= limb;
+
+        return bits == 0;
+    }
+
+    // Exchanges lhs and rhs when swap is set, with the same memory accesses either way
+    inline void cswap(Element& lhs, Element& rhs, bool swap) const
+    {
+        auto const mask = -static_cast<uint64_t>(swap);
+
+        for (auto i = 0uz; i < N; i++) {
+            auto const t = (lhs[i] ^ rhs[i]) & mask;
+
+            lhs[i] ^= t;
+            rhs[i] ^= t;
+        }
+    }
+};
+
+// The backends of the primes that Field reduces with dedicated code, built once and shared
+FixedField<4, FixedReduction::Fold> const& Secp256k1Field();
+FixedField<4, FixedReduction::Montgomery> const& P256Field();
+FixedField<6, FixedReduction::Montgomery> const& P384Field();
+FixedField<4, FixedReduction::Fold> const& Curve25519Field();
+
+template<typename F>
+decltype(auto) WithFixedField(Field const& field, F&& f)
+{
+    // f called with the fixed-width backend of the field's prime, or with field itself for any other prime
+    switch (field.get_reduction()) {
+    case Field::Reduction::Secp256k1:
+        return f(Secp256k1Field());
+    case Field::Reduction::P256:
+        return f(P256Field());
+    case Field::Reduction::P384:
+        return f(P384Field());
+    case Field::Reduction::Curve25519:
+        return f(Curve25519Field());
+    default:
+        return f(field);
+    }
+}
@@ -0,0 +1,201 @@
+#include <EllipticCurve/FixedField.h>
+#include <EllipticCurve/Montgomery.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+size_t constexpr batch = 64; // Results sharing one inversion in batch X25519
+
+BigInt Decode(X25519Key const& bytes)
+{
+    auto groups = std::deque<uint32_t>(bytes.size() / 4);
+
+    for (auto i = 0uz; i < bytes.size(); i++)
+        groups[i / 4] |= static_cast<uint32_t>(bytes[i]) << (8 * (i % 4));
+
+    return BigInt { std::move(groups) };
+}
+
+X25519Key Encode(BigInt const& value)
+{
+    auto bytes = X25519Key {};
+    auto const& groups = value.get_groups();
+
+    for (auto i = 0uz; i < bytes.size() && i / 4 < groups.size(); i++)
+        bytes[i] = static_cast<uint8_t>(groups[i / 4] >> (8 * (i % 4)));
+
+    return bytes;
+}
+
+X25519Key Clamp(X25519Key bytes)
+{
+    bytes[0] &= 248;
+    bytes[31] &= 127;
+    bytes[31] |= 64;
+
+    return bytes;
+}
+
+BigInt DecodeU(X25519Key bytes)
+{
+    bytes[31] &= 127;
+
+    return Decode(bytes);
+}
+
+template<class Arithmetic, typename Bit>
+std::pair<typename Arithmetic::Element, typename Arithmetic::Element> Ladder(Arithmetic const& F, typename Arithmetic::Element const& x1,
+                                                                             typename Arithmetic::Element const& a24, size_t bits, Bit&& bit)
+{
+    // RFC 7748 section 5, with (A + 2) / 4 in the doubling, over bit(bits - 1) down to bit(0). Returns (X : Z).
+    auto x2 = F.one();
+    auto z2 = F.zero();
+    auto x3 = x1;
+    auto z3 = F.one();
+    auto swapped = false;
+
+    for (auto i = bits; i-- > 0;) {
+        auto const set = bit(i);
+
+        F.cswap(x2, x3, swapped ^ set);
+        F.cswap(z2, z3, swapped ^ set);
+        swapped = set;
+
+        auto const a = F.add(x2, z2);
+        auto const aa = F.sqr(a);
+        auto const b = F.sub(x2, z2);
+        auto const bb = F.sqr(b);
+        auto const e = F.sub(aa, bb);
+        auto const c = F.add(x3, z3);
+        auto const d = F.sub(x3, z3);
+        auto const da = F.mul(d, a);
+        auto const cb = F.mul(c, b);
+
+        x3 = F.sqr(F.add(da, cb));
+        z3 = F.mul(x1, F.sqr(F.sub(da, cb)));
+        x2 = F.mul(aa, bb);
+        z2 = F.mul(e, F.add(bb, F.mul(a24, e)));
+    }
+
+    F.cswap(x2, x3, swapped);
+    F.cswap(z2, z3, swapped);
+
+    return { std::move(x2), std::move(z2) };
+}
+
+using Element25519 = FixedField<4, FixedReduction::Fold>::Element;
+
+std::pair<Element25519, Element25519> Ladder25519(X25519Key const& scalar, X25519Key const& u)
+{
+    // On the fixed-width backend of 2^255 - 19, reading the bits of the clamped scalar straight from its bytes
+    auto const& F = Curve25519Field();
+    auto static const a24 = F.to(121666); // (486662 + 2) / 4
+    auto const k = Clamp(scalar);
+
+    return Ladder(F, F.to(DecodeU(u)), a24, 255, [&k](size_t i) { return static_cast<bool>(k[i / 8] >> (i % 8) & 1); });
+}
+}
+
+MontgomeryCurve::MontgomeryCurve(BigInt a, BigInt b, BigInt field)
+    : m_field(field)
+    , m_a(a % field)
+    , m_b(b % field)
+    , m_arithmetic(field)
+{
+    if (!m_field.bit_at(0))
+        throw new std::runtime_error("[MontgomeryCurve] Field must be an odd prime");
+
+    m_a24_field = m_arithmetic.to((m_a + 2) * Modinv(BigInt { 4 }, m_field));
+}
+
+ProjectiveX MontgomeryCurve::ladder_projective(BigInt const& scalar, BigInt const& x, size_t bits) const
+{
+    auto [X, Z] = Ladder(m_arithmetic, m_arithmetic.to(x), m_a24_field, bits, [&scalar](size_t i) { return scalar.bit_at(i); });
+
+    return ProjectiveX { std::move(X), std::move(Z) };
+}
+
+BigInt MontgomeryCurve::ladder(BigInt const& scalar, BigInt const& x) const
+{
+    auto const k = scalar.abs();
+    auto const result = ladder_projective(k, x, std::max(k.size(), m_field.size()));
+
+    if (result.m_z.is_zero())
+        return 0;
+
+    auto const& F = m_arithmetic;
+
+    return F.from(F.mul(result.m_x, F.inv(result.m_z)));
+}
+
+MontgomeryCurve const& Curve25519()
+{
+    static auto const curve = MontgomeryCurve { 486662, 1, (BigInt { 1 } << 255) - 19 };
+
+    return curve;
+}
+
+X25519Key X25519(X25519Key const& scalar, X25519Key const& u)
+{
+    auto const& F = Curve25519Field();
+    auto const [x, z] = Ladder25519(scalar, u);
+
+    if (F.is_zero(z))
+        return X25519Key {};
+
+    return Encode(F.from(F.mul(x, F.inv(z))));
+}
+
+X25519Key X25519PublicKey(X25519Key const& scalar)
+{
+    return X25519(scalar, X25519Key { 9 });
+}
+
+std::vector<X25519Key> X25519(std::span<X25519Key const> scalars, std::span<X25519Key const> us, size_t threads)
+{
+    if (scalars.size() != 1 && scalars.size() != us.size())
+        throw new std::runtime_error("[X25519] Expected one scalar or one scalar per u-coordinate");
+
+    auto const& F = Curve25519Field();
+    auto results = std::vector<X25519Key>(us.size());
+
+    ParallelFor((us.size() + batch - 1) / batch, threads, [&](size_t group) {
+        auto const begin = group * batch;
+        auto const end = std::min(begin + batch, us.size());
+
+        auto points = std::vector<std::pair<Element25519, Element25519>> {};
+        auto prefix = std::vector<Element25519> {};
+
+        // Montgomery's trick, Z = 0 stands in as 1 and yields a zero result
+        for (auto i = begin; i < end; i++) {
+            auto const& scalar = scalars.size() == 1 ? scalars[0] : scalars[i];
+
+            points.push_back(Ladder25519(scalar, us[i]));
+
+            auto const& z = F.is_zero(points.back().second) ? F.one() : points.back().second;
+
+            prefix.push_back(prefix.empty() ? z : F.mul(prefix.back(), z));
+        }
+
+        auto inverse = F.inv(prefix.back());
+
+        for (auto i = points.size(); i-- > 0;) {
+            auto const& [x, z] = points[i];
+
+            if (F.is_zero(z))
+                continue;
+
+            auto const z_inverse = i ? F.mul(inverse, prefix[i - 1]) : inverse;
+
+            inverse = F.mul(inverse, z);
+            results[begin + i] = Encode(F.from(F.mul(x, z_inverse)));
+        }
+    });
+
+    return results;
+}
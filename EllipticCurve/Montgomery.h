@@ -0,0 +1,62 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/Field.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct ProjectiveX {
+    // x-only projective coordinate (X : Z) of the points (X / Z, +-y), Z = 0 for the point at infinity
+    BigInt m_x;
+    BigInt m_z;
+};
+
+class MontgomeryCurve {
+    /**
+     * Montgomery curve By^2 = x^3 + Ax^2 + x
+     * Scalar multiplication only needs x-coordinates: the ladder keeps (x([k]P), x([k + 1]P)), whose difference is
+     * always P, so each step is one differential addition and one doubling in (X : Z) coordinates. B plays no part.
+     * The pair is exchanged by a masked swap before and after each step, never by a branch on a scalar bit.
+     */
+private:
+    BigInt m_field;
+    BigInt m_a;
+    BigInt m_b;
+
+    Field m_arithmetic;
+    BigInt m_a24_field; // (A + 2) / 4 in field representation
+
+public:
+    MontgomeryCurve(BigInt a, BigInt b, BigInt field);
+
+    inline BigInt const& get_field() const { return m_field; }
+    inline BigInt const& get_a() const { return m_a; }
+    inline BigInt const& get_b() const { return m_b; }
+    inline Field const& get_arithmetic() const { return m_arithmetic; }
+
+    // (X : Z) of [k]P from x(P), over the low `bits` bits of k so that the work does not depend on its value
+    ProjectiveX ladder_projective(BigInt const& scalar, BigInt const& x, size_t bits) const;
+
+    // x([k]P) from x(P), 0 when [k]P is the point at infinity
+    BigInt ladder(BigInt const& scalar, BigInt const& x) const;
+};
+
+// y^2 = x^3 + 486662x^2 + x over 2^255 - 19, base point x = 9
+MontgomeryCurve const& Curve25519();
+
+/**
+ * X25519 Diffie-Hellman (RFC 7748)
+ * Scalars and u-coordinates are 32 little-endian bytes, scalars are clamped to a multiple of the cofactor 8
+ * with bit 254 set, and the top bit of u is ignored. The shared secret of a and B is X25519(a, B).
+ */
+using X25519Key = std::array<uint8_t, 32>;
+
+X25519Key X25519(X25519Key const& scalar, X25519Key const& u);
+X25519Key X25519PublicKey(X25519Key const& scalar);
+
+// X25519(scalars[i], us[i]) for every i, or of the single scalar against every u. The ladders are spread over
+// threads and each group of results shares one field inversion.
+std::vector<X25519Key> X25519(std::span<X25519Key const> scalars, std::span<X25519Key const> us, size_t threads = 0);
@@ -0,0 +1,151 @@
+#include <EllipticCurve/EllipticCurve.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+Point Straus(std::span<Point const> points, std::vector<BigInt> const& scalars)
+{
+    // One shared doubling chain, each term adds its wNAF digits from a table of odd multiples
+    auto const& curve = points[0].get_curve();
+    auto const w = 5uz;
+
+    auto nafs = std::vector<std::vector<int8_t>>(points.size());
+    auto tables = std::vector<std::vector<JacobianPoint>>(points.size());
+    auto length = 0uz;
+
+    for (auto i = 0uz; i < points.size(); i++) {
+        if (scalars[i].is_zero() || points[i].get_w() == 0)
+            continue;
+
+        nafs[i] = wNAF(scalars[i], w);
+        length = std::max(length, nafs[i].size());
+
+        auto& table = tables[i];
+        auto P2 = JacobianPoint { points[i] };
+        P2.dbl();
+
+        table.assign(1uz << (w - 2), JacobianPoint { points[i] });
+
+        for (auto j = 1uz; j < table.size(); j++)
+            (table[j] = table[j - 1]) += P2;
+    }
+
+    auto R = JacobianPoint { curve };
+
+    for (auto bit = length; bit-- > 0;) {
+        R.dbl();
+
+        for (auto i = 0uz; i < points.size(); i++) {
+            if (bit >= nafs[i].size() || !nafs[i][bit])
+                continue;
+
+            auto const digit = nafs[i][bit];
+
+            if (digit > 0)
+                R += tables[i][digit / 2];
+            else
+                R += -tables[i][-digit / 2];
+        }
+    }
+
+    return R.to_affine();
+}
+
+Point Pippenger(std::span<Point const> points, std::vector<BigInt> const& scalars, size_t threads)
+{
+    /**
+     * Pippenger's bucket method
+     * Scalars are cut into c-bit windows. Within a window every point is added into the bucket of its digit,
+     * and sum_d d * B_d falls out of a running sum from the top bucket down. Windows are independent and
+     * are spread across threads, then combined with c doublings between them.
+     */
+    auto const& curve = points[0].get_curve();
+    auto const& F = curve->get_arithmetic();
+
+    auto const c = std::max(2uz, static_cast<size_t>(std::bit_width(points.size())) - 2);
+    auto bits = 0uz;
+
+    for (auto const& scalar : scalars)
+        bits = std::max(bits, scalar.size());
+
+    auto const windows = (bits + c - 1) / c;
+
+    // Affine coordinates in field representation, converted once for all windows
+    auto affine = std::vector<Coordinate>(points.size());
+
+    for (auto i = 0uz; i < points.size(); i++) {
+        if (points[i].get_w() == 0) {
+            affine[i] = Coordinate { 0, 0, 0 };
+            continue;
+        }
+
+        affine[i] = Coordinate { F.to(points[i].get_x()), F.to(points[i].get_y()) };
+    }
+
+    auto sums = std::vector<JacobianPoint>(windows, JacobianPoint { curve });
+
+    ParallelFor(windows, threads, [&](size_t window) {
+        auto buckets = std::vector<JacobianPoint>((1uz << c) - 1, JacobianPoint { curve });
+
+        for (auto i = 0uz; i < points.size(); i++) {
+            auto digit = 0uz;
+
+            for (auto j = 0uz; j < c; j++)
+                digit |= static_cast<size_t>(scalars[i].bit_at(window * c + j)) << j;
+
+            if (digit)
+                buckets[digit - 1].add_affine(affine[i]);
+        }
+
+        auto running = JacobianPoint { curve };
+        auto& sum = sums[window];
+
+        for (auto d = buckets.size(); d-- > 0;) {
+            running += buckets[d];
+            sum += running;
+        }
+    });
+
+    auto R = JacobianPoint { curve };
+
+    for (auto window = windows; window-- > 0;) {
+        for (auto j = 0uz; j < c; j++)
+            R.dbl();
+
+        R += sums[window];
+    }
+
+    return R.to_affine();
+}
+}
+
+Point MultiScalarMul(std::span<Point const> points, std::span<BigInt const> scalars, size_t threads)
+{
+    if (points.size() != scalars.size())
+        throw new std::runtime_error("[MultiScalarMul] Points and scalars differ in length");
+
+    if (points.empty())
+        throw new std::runtime_error("[MultiScalarMul] Empty sum has no curve");
+
+    // Negative scalars move their sign onto the point
+    auto terms = std::vector<Point> {};
+    auto magnitudes = std::vector<BigInt> {};
+
+    terms.reserve(points.size());
+    magnitudes.reserve(points.size());
+
+    for (auto i = 0uz; i < points.size(); i++) {
+        assert(points[i] |= points[0]);
+
+        terms.push_back(scalars[i].is_negative() ? -points[i] : points[i]);
+        magnitudes.push_back(scalars[i].abs());
+    }
+
+    if (points.size() < 64)
+        return Straus(terms, magnitudes);
+
+    return Pippenger(terms, magnitudes, threads);
+}
@@ -0,0 +1,543 @@
+#include <EllipticCurve/EllipticCurve.h>
+#include <Modmath.h>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+Point RandomPoint(CurveContext const& curve)
+{
+    auto const& p = curve->get_field();
+
+    while (true) {
+        auto x = BigInt {};
+        x.random(static_cast<int>(p.size() + 16));
+        x = x % p;
+
+        auto const value = (x * (x * x + curve->get_a()) + curve->get_b()) % p;
+
+        if (auto const y = Modsqrt(value, p))
+            return Point::make_unchecked(x, *y, curve);
+    }
+}
+
+std::optional<std::vector<BigInt>> HasseMultiples(Point const& P, BigInt const& low, BigInt const& high)
+{
+    // Every k in [low, high] with kP = O, or nothing when P has an order too small to say anything
+    auto const m = static_cast<size_t>(Isqrt(high - low).to_uint64()) + 1;
+    auto const& p = P.get_field();
+
+    // Baby steps jP for 0 < j < m, bucketed by the low bits of x
+    auto babies = std::vector<Point> {};
+    auto index = std::unordered_map<uint64_t, std::vector<size_t>> {};
+
+    babies.reserve(m);
+    babies.push_back(Point::make_point_at_infinity(P.get_curve()));
+
+    for (auto j = 1uz; j < m; j++) {
+        babies.push_back(babies.back() + P);
+
+        if (babies.back().get_w() == 0)
+            return std::nullopt;
+
+        index[babies.back().get_x().to_uint64()].push_back(j);
+    }
+
+    // Giant steps (low + im)P, a match with -jP gives (low + im + j)P = O
+    auto const step = P.multiply(BigInt { static_cast<int64_t>(m) });
+    auto Q = P.multiply(low);
+    auto multiples = std::vector<BigInt> {};
+
+    for (auto k = low; k <= high; k += BigInt { static_cast<int64_t>(m) }, Q += step) {
+        if (Q.get_w() == 0) {
+            multiples.push_back(k);
+            continue;
+        }
+
+        auto const bucket = index.find(Q.get_x().to_uint64());
+
+        if (bucket == index.end())
+            continue;
+
+        for (auto const j : bucket->second) {
+            auto const& J = babies[j];
+            auto const candidate = k + BigInt { static_cast<int64_t>(j) };
+
+            if (J.get_x() == Q.get_x() && (J.get_y() + Q.get_y()) % p == 0 && candidate <= high)
+                multiples.push_back(candidate);
+        }
+    }
+
+    std::sort(multiples.begin(), multiples.end());
+
+    return multiples;
+}
+
+class Polynomials {
+    // Polynomials over F_p, coefficients in field representation from the constant term up, no trailing zeros
+public:
+    using Polynomial = std::vector<BigInt>;
+
+    Field const& F;
+
+    static void trim(Polynomial& a)
+    {
+        while (!a.empty() && a.back().is_zero())
+            a.pop_back();
+    }
+
+    static Polynomial trimmed(Polynomial a)
+    {
+        trim(a);
+        return a;
+    }
+
+    static long degree(Polynomial const& a) { return static_cast<long>(a.size()) - 1; }
+
+    Polynomial add(Polynomial const& a, Polynomial const& b) const
+    {
+        auto result = a.size() >= b.size() ? a : b;
+        auto const& other = a.size() >= b.size() ? b : a;
+
+        for (auto i = 0uz; i < other.size(); i++)
+            result[i] = F.add(result[i], other[i]);
+
+        trim(result);
+        return result;
+    }
+
+    Polynomial sub(Polynomial const& a, Polynomial const& b) const
+    {
+        auto result = a;
+        result.resize(std::max(a.size(), b.size()));
+
+        for (auto i = 0uz; i < b.size(); i++)
+            result[i] = F.sub(result[i], b[i]);
+
+        trim(result);
+        return result;
+    }
+
+    Polynomial scale(Polynomial const& a, BigInt const& c) const
+    {
+        auto result = a;
+
+        for (auto& coefficient : result)
+            coefficient = F.mul(coefficient, c);
+
+        trim(result);
+        return result;
+    }
+
+    Polynomial mul(Polynomial const& a, Polynomial const& b) const
+    {
+        if (a.empty() || b.empty())
+            return {};
+
+        auto result = Polynomial(a.size() + b.size() - 1);
+
+        for (auto i = 0uz; i < a.size(); i++) {
+            if (a[i].is_zero())
+                continue;
+
+            for (auto j = 0uz; j < b.size(); j++)
+                result[i + j] = F.add(result[i + j], F.mul(a[i], b[j]));
+        }
+
+        trim(result);
+        return result;
+    }
+
+    std::pair<Polynomial, Polynomial> divrem(Polynomial const& a, Polynomial const& b) const
+    {
+        auto remainder = a;
+
+        if (a.size() < b.size())
+            return { {}, remainder };
+
+        auto const lead = F.inv(b.back());
+        auto quotient = Polynomial(a.size() - b.size() + 1);
+
+        for (auto i = quotient.size(); i-- > 0;) {
+            auto const c = F.mul(remainder[i + b.size() - 1], lead);
+
+            quotient[i] = c;
+
+            if (c.is_zero())
+                continue;
+
+            for (auto j = 0uz; j < b.size(); j++)
+                remainder[i + j] = F.sub(remainder[i + j], F.mul(c, b[j]));
+        }
+
+        trim(quotient);
+        trim(remainder);
+        return { quotient, remainder };
+    }
+
+    Polynomial mod(Polynomial const& a, Polynomial const& h) const { return divrem(a, h).second; }
+
+    Polynomial mulmod(Polynomial const& a, Polynomial const& b, Polynomial const& h) const { return mod(mul(a, b), h); }
+
+    Polynomial powmod(Polynomial const& a, BigInt const& exponent, Polynomial const& h) const
+    {
+        auto result = mod(Polynomial { F.one() }, h);
+        auto const base = mod(a, h);
+
+        for (auto i = exponent.size(); i-- > 0;) {
+            result = mulmod(result, result, h);
+
+            if (exponent.bit_at(i))
+                result = mulmod(result, base, h);
+        }
+
+        return result;
+    }
+
+    Polynomial monic(Polynomial const& a) const { return a.empty() ? a : scale(a, F.inv(a.back())); }
+
+    Polynomial gcd(Polynomial a, Polynomial b) const
+    {
+        while (!b.empty())
+            a = std::exchange(b, mod(a, b));
+
+        return monic(a);
+    }
+};
+
+using Polynomial = Polynomials::Polynomial;
+
+struct Factor {
+    // A proper factor of the modulus, found where an element was neither zero nor a unit
+    Polynomial g;
+};
+
+struct RingPoint {
+    // The point (a(x), y b(x)) over F_p[x, y] / (h(x), y^2 - f(x))
+    Polynomial a;
+    Polynomial b;
+    bool infinity = false;
+};
+
+class TorsionRing {
+    // Group law on the l-torsion, carried out modulo a factor h of the l-th division polynomial
+public:
+    Polynomials const& R;
+    Polynomial h;
+    Polynomial f; // x^3 + ax + b mod h
+    BigInt const& A;
+
+    bool same(Polynomial const& u, Polynomial const& v) const
+    {
+        // u = v on every root of h, or on none of them; anything in between splits h
+        auto const d = R.sub(u, v);
+
+        if (d.empty())
+            return true;
+
+        auto g = R.gcd(d, h);
+
+        if (Polynomials::degree(g) > 0)
+            throw Factor { std::move(g) };
+
+        return false;
+    }
+
+    Polynomial inverse(Polynomial const& u) const
+    {
+        auto r0 = h;
+        auto r1 = R.mod(u, h);
+        auto s0 = Polynomial {};
+        auto s1 = Polynomial { R.F.one() };
+
+        while (!r1.empty()) {
+            auto [q, r] = R.divrem(r0, r1);
+
+            r0 = std::exchange(r1, std::move(r));
+            s0 = std::exchange(s1, R.sub(s0, R.mul(q, s1)));
+        }
+
+        if (Polynomials::degree(r0) > 0)
+            throw Factor { R.monic(r0) };
+
+        return R.mod(R.scale(s0, R.F.inv(r0[0])), h);
+    }
+
+    RingPoint dbl(RingPoint const& P) const
+    {
+        // y^2 = f turns the slope (3a^2 + A) / 2yb into y (3a^2 + A) / 2bf
+        if (P.infinity)
+            return P;
+
+        auto const aa = R.mulmod(P.a, P.a, h);
+        auto const numerator = R.add(R.add(R.add(aa, aa), aa), Polynomial { A });
+        auto const r = R.mulmod(numerator, inverse(R.mulmod(R.add(P.b, P.b), f, h)), h);
+        auto const x = R.sub(R.mulmod(f, R.mulmod(r, r, h), h), R.add(P.a, P.a));
+
+        return RingPoint { x, R.sub(R.mulmod(r, R.sub(P.a, x), h), P.b) };
+    }
+
+    RingPoint add(RingPoint const& P, RingPoint const& Q) const
+    {
+        if (P.infinity)
+            return Q;
+
+        if (Q.infinity)
+            return P;
+
+        if (same(P.a, Q.a))
+            return same(P.b, Q.b) ? dbl(P) : RingPoint { {}, {}, true };
+
+        auto const r = R.mulmod(R.sub(Q.b, P.b), inverse(R.sub(Q.a, P.a)), h);
+        auto const x = R.sub(R.sub(R.mulmod(f, R.mulmod(r, r, h), h), P.a), Q.a);
+
+        return RingPoint { x, R.sub(R.mulmod(r, R.sub(P.a, x), h), P.b) };
+    }
+
+    RingPoint multiply(uint64_t k, RingPoint const& P) const
+    {
+        auto result = RingPoint { {}, {}, true };
+
+        for (auto i = 64; i-- > 0;) {
+            result = dbl(result);
+
+            if ((k >> i) & 1)
+                result = add(result, P);
+        }
+
+        return result;
+    }
+
+    RingPoint reduce(RingPoint const& P) const { return RingPoint { R.mod(P.a, h), R.mod(P.b, h), P.infinity }; }
+};
+
+uint64_t TraceModulo(uint64_t l, BigInt const& p, Polynomials const& R, Polynomial const& psi, Polynomial const& curve, BigInt const& A)
+{
+    /**
+     * The Frobenius endomorphism satisfies pi^2 - t pi + p = 0 on E[l], so t mod l is the tau with
+     * pi^2(P) + (p mod l) P = tau pi(P) for the l-torsion points P. Everything is computed on a generic
+     * l-torsion point, over the ring F_p[x, y] / (psi_l(x), y^2 - f(x)). Should psi_l split along the way,
+     * the work continues on the factor; the relation holds on any subset of E[l].
+     */
+    auto ring = TorsionRing { R, R.monic(psi), {}, A };
+    ring.f = R.mod(curve, ring.h);
+
+    auto const x = Polynomial { {}, R.F.one() };
+
+    // pi(P) = (x^p, y f^((p - 1) / 2)) and pi^2(P) = (x^(p^2), y f^((p^2 - 1) / 2))
+    auto const xp = R.powmod(x, p, ring.h);
+    auto const bp = R.powmod(ring.f, (p - 1) >> 1, ring.h);
+    auto const pi = RingPoint { xp, bp };
+    auto const pi2 = RingPoint { R.powmod(xp, p, ring.h), R.mulmod(bp, R.powmod(bp, p, ring.h), ring.h) };
+
+    auto const q = (p % l).to_uint64();
+
+    while (true) {
+        try {
+            auto const P1 = ring.reduce(pi);
+            auto const P2 = ring.reduce(pi2);
+            auto const base = RingPoint { R.mod(x, ring.h), Polynomial { R.F.one() } };
+            auto const Q = ring.multiply(q, base);
+
+            if (ring.same(P2.a, Q.a)) {
+                // pi^2 = -q gives t = 0, otherwise pi^2 = q and t = +-2w for w^2 = q mod l, if pi = +-w at all
+                if (!ring.same(P2.b, Q.b))
+                    return 0;
+
+                auto w = 1uz;
+
+                while (w < l && (w * w) % l != q)
+                    w++;
+
+                if (w == l)
+                    return 0;
+
+                auto const W = ring.multiply(w, base);
+
+                if (!ring.same(P1.a, W.a))
+                    return 0;
+
+                return ring.same(P1.b, W.b) ? (2 * w) % l : l - (2 * w) % l;
+            }
+
+            auto const S = ring.add(P2, Q);
+            auto T = P1;
+
+            for (auto tau = 1uz; tau <= (l - 1) / 2; tau++) {
+                if (ring.same(T.a, S.a))
+                    return ring.same(T.b, S.b) ? tau : l - tau;
+
+                T = ring.add(T, P1);
+            }
+
+            throw new std::runtime_error("[SchoofOrder] No trace found");
+        } catch (Factor const& factor) {
+            ring.h = factor.g;
+            ring.f = R.mod(curve, ring.h);
+        }
+    }
+}
+}
+
+BigInt MestreOrder(CurveContext const& curve)
+{
+    /**
+     * Baby-step giant-step over the Hasse interval [p + 1 - 2 sqrt(p), p + 1 + 2 sqrt(p)]
+     * A random point narrows the order down to the multiples of its own order inside the interval. Points
+     * of the quadratic twist E' count too, as #E = 2p + 2 - #E'. Mestre showed that for p > 229 one of E
+     * and E' has a point with a single multiple in the interval.
+     */
+    auto const& p = curve->get_field();
+    auto const bound = Isqrt(p * 4);
+    auto const low = p + 1 - bound;
+    auto const high = p + 1 + bound;
+
+    // E': y^2 = x^3 + ad^2 x + bd^3 for a non-residue d
+    auto d = BigInt { 2 };
+
+    while (Legendre(d, p) != -1)
+        d += 1;
+
+    auto const twist = Curve::make((curve->get_a() * d * d) % p, (curve->get_b() * d * d * d) % p, p);
+
+    auto candidates = std::optional<std::vector<BigInt>> {};
+
+    auto const narrow = [&](std::vector<BigInt> multiples) {
+        std::sort(multiples.begin(), multiples.end());
+
+        if (!candidates) {
+            candidates = std::move(multiples);
+            return;
+        }
+
+        auto intersection = std::vector<BigInt> {};
+        std::set_intersection(candidates->begin(), candidates->end(), multiples.begin(), multiples.end(), std::back_inserter(intersection));
+        candidates = std::move(intersection);
+    };
+
+    for (auto attempt = 0; attempt < 64; attempt++) {
+        if (auto const multiples = HasseMultiples(RandomPoint(curve), low, high))
+            narrow(*multiples);
+
+        if (candidates && candidates->size() == 1)
+            return candidates->front();
+
+        if (auto const multiples = HasseMultiples(RandomPoint(twist), low, high)) {
+            auto orders = std::vector<BigInt> {};
+
+            for (auto const& multiple : *multiples)
+                orders.push_back(p * 2 + 2 - multiple);
+
+            narrow(std::move(orders));
+        }
+
+        if (candidates && candidates->size() == 1)
+            return candidates->front();
+    }
+
+    throw new std::runtime_error("[MestreOrder] Group order is not determined by the Hasse interval");
+}
+
+BigInt SchoofOrder(CurveContext const& curve)
+{
+    /**
+     * Schoof's algorithm
+     * #E = p + 1 - t with |t| <= 2 sqrt(p). t mod 2 follows from whether x^3 + ax + b has a root, and
+     * t mod l for odd primes l from the action of Frobenius on E[l]. Primes are added until their product
+     * exceeds 4 sqrt(p), then t is recovered by the Chinese remainder theorem.
+     */
+    auto const& p = curve->get_field();
+    auto const& F = curve->get_arithmetic();
+    auto const R = Polynomials { F };
+
+    if (p <= 3)
+        throw new std::runtime_error("[SchoofOrder] Field characteristic must exceed 3");
+
+    auto const c = [&F](int64_t value) { return F.to(BigInt { value }); };
+    auto const& A = curve->get_a_field();
+    auto const& B = curve->get_b_field();
+
+    auto const x = Polynomial { {}, F.one() };
+    auto const f = Polynomials::trimmed(Polynomial { B, A, {}, F.one() });
+
+    // Primes l, besides 2, until the product exceeds 4 sqrt(p)
+    auto const bound = Isqrt(p * 16) + 1;
+    auto primes = std::vector<uint64_t> {};
+    auto product = BigInt { 2 };
+
+    for (auto l = 3u; product <= bound; l += 2) {
+        if (!MillerRabin(BigInt { l }) && p != l) {
+            primes.push_back(l);
+            product *= static_cast<uint64_t>(l);
+        }
+    }
+
+    /**
+     * Division polynomials with the y factor of the even ones taken out: psi_n = f_n for odd n and
+     * psi_n = y f_n for even n, so that y^2 = x^3 + ax + b only shows up as a factor of (x^3 + ax + b)^2.
+     */
+    auto const lmax = primes.back();
+    auto const half = F.inv(c(2));
+    auto const f2 = R.mul(f, f);
+    auto psi = std::vector<Polynomial>(std::max<uint64_t>(lmax + 1, 5));
+
+    auto const AA = F.sqr(A);
+    auto const BB = F.sqr(B);
+    auto const AB = F.mul(A, B);
+
+    psi[0] = {};
+    psi[1] = { F.one() };
+    psi[2] = { c(2) };
+    psi[3] = { F.neg(AA), F.mul(c(12), B), F.mul(c(6), A), {}, c(3) };
+    psi[4] = Polynomials::trimmed({ F.mul(c(-4), F.add(F.mul(c(8), BB), F.mul(AA, A))), F.mul(c(-16), AB), F.mul(c(-20), AA), F.mul(c(80), B), F.mul(c(20), A), {}, c(4) });
+
+    for (auto n = 5uz; n <= lmax; n++) {
+        auto const m = n / 2;
+        auto const cube = [&R](Polynomial const& u) { return R.mul(R.mul(u, u), u); };
+
+        if (n % 2) {
+            auto lhs = R.mul(psi[m + 2], cube(psi[m]));
+            auto rhs = R.mul(psi[m - 1], cube(psi[m + 1]));
+
+            if (m % 2 == 0)
+                lhs = R.mul(lhs, f2);
+            else
+                rhs = R.mul(rhs, f2);
+
+            psi[n] = R.sub(lhs, rhs);
+        } else {
+            auto const lhs = R.mul(psi[m + 2], R.mul(psi[m - 1], psi[m - 1]));
+            auto const rhs = R.mul(psi[m - 2], R.mul(psi[m + 1], psi[m + 1]));
+
+            psi[n] = R.scale(R.mul(psi[m], R.sub(lhs, rhs)), half);
+        }
+    }
+
+    // t is even exactly when E has a point of order 2, a root of x^3 + ax + b
+    auto const xp = R.powmod(x, p, f);
+    auto residue = BigInt { Polynomials::degree(R.gcd(R.sub(xp, x), f)) > 0 ? 0 : 1 };
+    auto modulus = BigInt { 2 };
+
+    for (auto const l : primes) {
+        auto const t = TraceModulo(l, p, R, psi[l], f, A);
+
+        // Lift residue mod modulus to t mod l
+        auto const r = (residue % l).to_uint64();
+        auto const m = (modulus % l).to_uint64();
+        auto inverse = 1uz;
+
+        while ((m * inverse) % l != 1)
+            inverse++;
+
+        residue += modulus * (((t + l - r) % l * inverse) % l);
+        modulus *= l;
+    }
+
+    if (residue > modulus / 2)
+        residue -= modulus;
+
+    return p + 1 - residue;
+}
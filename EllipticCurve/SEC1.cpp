@@ -0,0 +1,158 @@
+#include <EllipticCurve/SEC1.h>
+#include <Parallel.h>
+
+#include <atomic>
+#include <deque>
+#include <stdexcept>
+
+namespace {
+size_t ElementLength(Curve const& curve) { return (curve.get_field().size() + 7) / 8; }
+
+size_t EncodingLength(uint8_t prefix, size_t length)
+{
+    switch (prefix) {
+    case 0x00:
+        return 1;
+    case 0x02:
+    case 0x03:
+        return 1 + length;
+    case 0x04:
+        return 1 + 2 * length;
+    default:
+        throw new std::runtime_error("[SEC1] Unknown point encoding");
+    }
+}
+}
+
+BigInt OctetsToInteger(std::span<uint8_t const> bytes)
+{
+    auto groups = std::deque<uint32_t>((bytes.size() + 3) / 4 + 1);
+
+    for (auto i = 0uz; i < bytes.size(); i++) {
+        auto const position = bytes.size() - 1 - i;
+        groups[position / 4] |= static_cast<uint32_t>(bytes[i]) << (8 * (position % 4));
+    }
+
+    return BigInt { std::move(groups) };
+}
+
+std::vector<uint8_t> IntegerToOctets(BigInt const& value, size_t length)
+{
+    // The low `length` bytes of |value|
+    auto bytes = std::vector<uint8_t>(length);
+    auto const& groups = value.get_groups();
+
+    for (auto i = 0uz; i < length && i / 4 < groups.size(); i++)
+        bytes[length - 1 - i] = static_cast<uint8_t>(groups[i / 4] >> (8 * (i % 4)));
+
+    return bytes;
+}
+
+std::vector<uint8_t> EncodePoint(Point const& point, bool compressed)
+{
+    if (point.get_w() == 0)
+        return { 0x00 };
+
+    auto const length = ElementLength(*point.get_curve());
+    auto const x = IntegerToOctets(point.get_x(), length);
+
+    auto bytes = std::vector<uint8_t> { static_cast<uint8_t>(compressed ? 0x02 | point.get_y().bit_at(0) : 0x04) };
+    bytes.insert(bytes.end(), x.begin(), x.end());
+
+    if (!compressed) {
+        auto const y = IntegerToOctets(point.get_y(), length);
+        bytes.insert(bytes.end(), y.begin(), y.end());
+    }
+
+    return bytes;
+}
+
+Point DecodePoint(std::span<uint8_t const> bytes, CurveContext const& curve)
+{
+    auto const length = ElementLength(*curve);
+
+    if (bytes.empty() || bytes.size() != EncodingLength(bytes[0], length))
+        throw new std::runtime_error("[SEC1] Malformed point encoding");
+
+    if (bytes[0] == 0x00)
+        return Point::make_point_at_infinity(curve);
+
+    auto const& F = curve->get_arithmetic();
+    auto const& p = curve->get_field();
+    auto const x = OctetsToInteger(bytes.subspan(1, length));
+
+    if (x >= p)
+        throw new std::runtime_error("[SEC1] Coordinate out of range");
+
+    // y^2 = x^3 + ax + b
+    auto const X = F.to(x);
+    auto const rhs = F.add(F.mul(F.add(F.sqr(X), curve->get_a_field()), X), curve->get_b_field());
+
+    if (bytes[0] == 0x04) {
+        auto const y = OctetsToInteger(bytes.subspan(1 + length, length));
+
+        if (y >= p)
+            throw new std::runtime_error("[SEC1] Coordinate out of range");
+
+        if (F.sqr(F.to(y)) != rhs)
+            throw new std::runtime_error("[SEC1] Point is not on the curve");
+
+        return Point::make_unchecked(x, y, curve);
+    }
+
+    auto const root = F.sqrt(rhs);
+
+    if (!root)
+        throw new std::runtime_error("[SEC1] Point is not on the curve");
+
+    auto y = F.from(*root);
+
+    if (y.bit_at(0) != static_cast<bool>(bytes[0] & 1)) {
+        // y = 0 has no odd partner
+        if (y.is_zero())
+            throw new std::runtime_error("[SEC1] Point is not on the curve");
+
+        y = p - y;
+    }
+
+    return Point::make_unchecked(x, y, curve);
+}
+
+std::vector<Point> DecodePoints(std::span<uint8_t const> bytes, CurveContext const& curve, size_t threads)
+{
+    // Offsets first, every prefix gives the length of its encoding
+    auto const length = ElementLength(*curve);
+    auto offsets = std::vector<size_t> {};
+
+    auto offset = 0uz;
+
+    while (offset < bytes.size()) {
+        offsets.push_back(offset);
+        offset += EncodingLength(bytes[offset], length);
+    }
+
+    if (offset != bytes.size())
+        throw new std::runtime_error("[SEC1] Malformed point encoding");
+
+    offsets.push_back(offset);
+
+    auto points = std::vector<Point>(offsets.size() - 1, Point::make_point_at_infinity(curve));
+    auto error = std::atomic<std::runtime_error*> { nullptr };
+
+    // The first error of any worker is rethrown on the calling thread
+    ParallelFor(points.size(), threads, [&](size_t i) {
+        try {
+            points[i] = DecodePoint(bytes.subspan(offsets[i], offsets[i + 1] - offsets[i]), curve);
+        } catch (std::runtime_error* e) {
+            auto* expected = static_cast<std::runtime_error*>(nullptr);
+
+            if (!error.compare_exchange_strong(expected, e))
+                delete e;
+        }
+    });
+
+    if (error)
+        throw error.load();
+
+    return points;
+}
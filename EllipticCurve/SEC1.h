@@ -0,0 +1,24 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+#include <EllipticCurve/EllipticCurve.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * SEC 1 v2 octet strings (section 2.3)
+ * Integers are big-endian and field elements take ceil(log2(p) / 8) bytes. A point is 0x00 at infinity,
+ * 0x02 or 0x03 (the parity of y) followed by x when compressed, or 0x04 followed by x and y.
+ */
+BigInt OctetsToInteger(std::span<uint8_t const> bytes);
+std::vector<uint8_t> IntegerToOctets(BigInt const& value, size_t length);
+
+std::vector<uint8_t> EncodePoint(Point const& point, bool compressed = true);
+
+// Throws on malformed encodings and points off the curve. A compressed y is recovered by a square root.
+Point DecodePoint(std::span<uint8_t const> bytes, CurveContext const& curve);
+
+// Decodes back-to-back encodings, which may mix forms, over threads
+std::vector<Point> DecodePoints(std::span<uint8_t const> bytes, CurveContext const& curve, size_t threads = 0);
@@ -0,0 +1,199 @@
+#include <Factorization/Factorization.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+size_t footprint(std::vector<BigInt> const& level)
+{
+    auto bytes = 0uz;
+
+    for (auto const& value : level)
+        bytes += value.groups() * sizeof(uint32_t);
+
+    return bytes;
+}
+
+class ProductTree {
+    // Levels of the product tree, from the leaves up to the one below the root. The leaves are the caller's
+    // moduli and are not copied. Levels above them are held in memory until the memory limit is reached, after
+    // which they are streamed to files in the spill directory and read back on demand.
+private:
+    BatchGCDParameters const& m_parameters;
+    std::vector<BigInt> const& m_leaves;
+    std::string m_tag { std::to_string(std::random_device {}()) };
+    size_t m_resident { 0 };
+    std::vector<std::vector<BigInt>> m_levels; // Empty for the leaves and for spilled levels
+    std::vector<std::filesystem::path> m_files;
+    BigInt m_root;
+
+    std::filesystem::path path(size_t level) const
+    {
+        return m_parameters.spill_directory / ("batchgcd-" + m_tag + "-" + std::to_string(level) + ".bin");
+    }
+
+    void write(size_t level, std::vector<BigInt> const& values)
+    {
+        auto file = std::ofstream { path(level), std::ios::binary | std::ios::trunc };
+
+        if (!file)
+            throw new std::runtime_error("[BatchGCD] Unable to open spill file");
+
+        auto const count = static_cast<uint64_t>(values.size());
+        file.write(reinterpret_cast<char const*>(&count), sizeof(count));
+
+        for (auto const& value : values) {
+            auto const& groups = value.get_groups();
+            auto const size = static_cast<uint64_t>(groups.size());
+            auto const buffer = std::vector<uint32_t>(groups.begin(), groups.end());
+
+            file.write(reinterpret_cast<char const*>(&size), sizeof(size));
+            file.write(reinterpret_cast<char const*>(buffer.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+        }
+    }
+
+    std::vector<BigInt> read(size_t level) const
+    {
+        auto file = std::ifstream { path(level), std::ios::binary };
+
+        if (!file)
+            throw new std::runtime_error("[BatchGCD] Unable to open spill file");
+
+        auto count = uint64_t {};
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+        auto values = std::vector<BigInt> {};
+        values.reserve(count);
+
+        for (auto i = 0uz; i < count; i++) {
+            auto size = uint64_t {};
+            file.read(reinterpret_cast<char*>(&size), sizeof(size));
+
+            auto buffer = std::vector<uint32_t>(size);
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size * sizeof(uint32_t)));
+
+            values.emplace_back(std::deque<uint32_t>(buffer.begin(), buffer.end()));
+        }
+
+        return values;
+    }
+
+    std::vector<BigInt> const& push(std::vector<BigInt> level, std::vector<BigInt>& spilled)
+    {
+        // Stores a level and returns it, from spilled when it went to disk
+        auto const bytes = footprint(level);
+        auto const index = m_levels.size();
+
+        if (m_parameters.memory_limit && m_resident + bytes > m_parameters.memory_limit) {
+            write(index, level);
+            m_files.push_back(path(index));
+            m_levels.emplace_back();
+            spilled = std::move(level);
+            return spilled;
+        }
+
+        m_resident += bytes;
+        m_levels.push_back(std::move(level));
+        return m_levels.back();
+    }
+
+public:
+    ProductTree(std::vector<BigInt> const& leaves, BatchGCDParameters const& parameters, size_t threads)
+        : m_parameters(parameters)
+        , m_leaves(leaves)
+    {
+        auto spilled = std::vector<BigInt> {};
+        auto const* below = &leaves;
+
+        m_levels.emplace_back();
+
+        while (below->size() > 2) {
+            auto level = std::vector<BigInt>((below->size() + 1) / 2);
+
+            ParallelFor(level.size(), threads, [&](size_t i) {
+                level[i] = 2 * i + 1 < below->size() ? (*below)[2 * i] * (*below)[2 * i + 1] : (*below)[2 * i];
+            });
+
+            below = &push(std::move(level), spilled);
+        }
+
+        m_root = (*below)[0] * (*below)[1];
+    }
+
+    ~ProductTree()
+    {
+        for (auto const& file : m_files)
+            std::filesystem::remove(file);
+    }
+
+    size_t size() const { return m_levels.size(); }
+
+    BigInt const& get_root() const { return m_root; }
+
+    // A resident level in place, a spilled one read into buffer
+    std::vector<BigInt> const& get(size_t level, std::vector<BigInt>& buffer) const
+    {
+        if (level == 0)
+            return m_leaves;
+
+        if (m_levels[level].empty()) {
+            buffer = read(level);
+            return buffer;
+        }
+
+        return m_levels[level];
+    }
+
+    // Frees a resident level that is no longer needed
+    void release(size_t level)
+    {
+        m_resident -= footprint(m_levels[level]);
+        m_levels[level] = {};
+    }
+};
+}
+
+std::vector<BigInt> BatchGCD(std::vector<BigInt> const& moduli, BatchGCDParameters const& parameters)
+{
+    /**
+     * Bernstein's batch gcd, "How to find smooth parts of integers"
+     * The product P of all moduli is reduced down a remainder tree modulo N_i^2, so that the leaves hold
+     * z_i = P mod N_i^2. Then gcd(N_i, z_i / N_i) = gcd(N_i, prod_{j != i} N_j).
+     */
+    auto const threads = HardwareThreads(parameters.threads);
+
+    if (moduli.size() < 2)
+        return std::vector<BigInt>(moduli.size(), BigInt { 1 });
+
+    auto tree = ProductTree { moduli, parameters, threads };
+
+    // Remainder tree, the root itself is the product. Each level is released once the one below is reduced,
+    // so the descent holds a level of the tree and two levels of remainders at a time.
+    auto remainders = std::vector<BigInt> { tree.get_root() };
+    auto buffer = std::vector<BigInt> {};
+
+    for (auto depth = tree.size(); depth-- > 0;) {
+        auto const& nodes = tree.get(depth, buffer);
+        auto next = std::vector<BigInt>(nodes.size());
+
+        ParallelFor(next.size(), threads, [&](size_t i) {
+            next[i] = remainders[i / 2] % (nodes[i] * nodes[i]);
+        });
+
+        remainders = std::move(next);
+        buffer.clear();
+        tree.release(depth);
+    }
+
+    auto result = std::vector<BigInt>(moduli.size());
+
+    ParallelFor(moduli.size(), threads, [&](size_t i) {
+        result[i] = gcd(moduli[i], remainders[i] / moduli[i]);
+    });
+
+    return result;
+}
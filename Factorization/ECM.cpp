@@ -0,0 +1,296 @@
+#include <Factorization/Factorization.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace {
+struct XZ {
+    // Projective x-only coordinate (X : Z) on a Montgomery curve, Z = 0 is the point at infinity
+    BigInt x;
+    BigInt z;
+};
+
+class MontgomeryCurve {
+    // By^2 = x^3 + Ax^2 + x over Z/nZ, only (A + 2) / 4 is needed for x-only arithmetic
+private:
+    BigInt const& m_n;
+    BigInt m_a24;
+
+    inline BigInt mul(BigInt const& a, BigInt const& b) const { return (a * b) % m_n; }
+
+public:
+    MontgomeryCurve(BigInt const& n, BigInt a24)
+        : m_n(n)
+        , m_a24(a24)
+    {
+    }
+
+    XZ dbl(XZ const& P) const
+    {
+        auto const s = mul(P.x + P.z, P.x + P.z);
+        auto const d = mul(P.x - P.z, P.x - P.z);
+        auto const t = s - d;
+
+        return { mul(s, d), mul(t, d + mul(m_a24, t)) };
+    }
+
+    XZ add(XZ const& P, XZ const& Q, XZ const& difference) const
+    {
+        // Differential addition; computes P + Q given P - Q
+        auto const u = mul(P.x - P.z, Q.x + Q.z);
+        auto const v = mul(P.x + P.z, Q.x - Q.z);
+
+        return { mul(difference.z, mul(u + v, u + v)), mul(difference.x, mul(u - v, u - v)) };
+    }
+
+    std::pair<XZ, XZ> ladder(XZ const& P, uint64_t k) const
+    {
+        // Montgomery ladder, returns ([k]P, [k + 1]P) for k >= 1
+        auto R0 = P;
+        auto R1 = dbl(P);
+
+        for (auto i = 63 - __builtin_clzll(k); i-- > 0;) {
+            if ((k >> i) & 1) {
+                R0 = add(R1, R0, P);
+                R1 = dbl(R1);
+            } else {
+                R1 = add(R1, R0, P);
+                R0 = dbl(R0);
+            }
+        }
+
+        return { R0, R1 };
+    }
+};
+
+std::optional<BigInt> nontrivial(BigInt const& d, BigInt const& n)
+{
+    if (d == 1 || d == n)
+        return {};
+
+    return d;
+}
+
+std::optional<BigInt> ECMCurve(BigInt const& n,
+                               uint64_t sigma,
+                               ECMParameters const& parameters,
+                               std::vector<uint32_t> const& primes,
+                               std::stop_token const& stop)
+{
+    // Run both stages of ECM on the curve given by Suyama's parametrization with parameter sigma
+    auto const s = BigInt { static_cast<int64_t>(sigma) };
+    auto const u = (s * s - 5) % n;
+    auto const v = (s * 4) % n;
+    auto const u3 = (u * u * u) % n;
+    auto const v3 = (v * v * v) % n;
+
+    // (A + 2) / 4 = (v - u)^3 (3u + v) / (16 u^3 v)
+    auto const denominator = (u3 * v * 16) % n;
+    auto const g = gcd(denominator, n);
+
+    if (g != 1)
+        return nontrivial(g, n);
+
+    auto const vu = v - u;
+    auto const curve = MontgomeryCurve { n, (((vu * vu * vu) % n) * (u * 3 + v) % n) * Modinv(denominator, n) % n };
+    auto Q = XZ { u3, v3 };
+
+    // Stage 1: Q <- [k]Q where k is the product of all maximal prime powers <= B1
+    for (auto i = 0uz; i < primes.size() && primes[i] <= parameters.B1; i++) {
+        if (i % 64 == 0 && stop.stop_requested())
+            return {};
+
+        auto const p = static_cast<uint64_t>(primes[i]);
+        auto q = p;
+
+        while (q <= parameters.B1 / p)
+            q *= p;
+
+        Q = curve.ladder(Q, q).first;
+    }
+
+    if (auto const d = gcd(Q.z, n); d != 1)
+        return nontrivial(d, n);
+
+    if (parameters.B2 <= parameters.B1)
+        return {};
+
+    // Stage 2: baby-step giant-step continuation, looks for a single prime p in (B1, B2] with
+    // [p]Q = 0 (mod q). Write p = mD +/- j, then x([mD]Q) = x([j]Q) (mod q) which is detected by
+    // accumulating the product of X_mD * Z_j - X_j * Z_mD.
+    auto const D = uint64_t { parameters.B2 < 2310 * 64 ? 210u : 2310u };
+
+    // Baby steps [j]Q for 1 <= j < D / 2 odd; those coprime to D are kept
+    auto baby = std::vector<std::pair<uint64_t, XZ>> {};
+    {
+        auto const Q2 = curve.dbl(Q);
+        auto previous = Q;
+        auto current = curve.add(Q2, Q, Q);
+
+        baby.push_back({ 1, Q });
+
+        for (auto j = uint64_t { 3 }; j < D / 2; j += 2) {
+            if (std::gcd(j, D) == 1)
+                baby.push_back({ j, current });
+
+            auto next = curve.add(current, Q2, previous);
+            previous = std::move(current);
+            current = std::move(next);
+        }
+    }
+
+    // Normalize baby steps to Z = 1 with a single inversion (Montgomery's trick)
+    {
+        auto prefix = std::vector<BigInt>(baby.size());
+        auto accumulator = BigInt { 1 };
+
+        for (auto i = 0uz; i < baby.size(); i++) {
+            prefix[i] = accumulator;
+            accumulator = (accumulator * baby[i].second.z) % n;
+        }
+
+        if (auto const d = gcd(accumulator, n); d != 1)
+            return nontrivial(d, n);
+
+        auto inverse = Modinv(accumulator, n);
+
+        for (auto i = baby.size(); i-- > 0;) {
+            auto const zinv = (inverse * prefix[i]) % n;
+            inverse = (inverse * baby[i].second.z) % n;
+
+            baby[i].second.x = (baby[i].second.x * zinv) % n;
+            baby[i].second.z = 1;
+        }
+    }
+
+    auto const root = static_cast<uint64_t>(std::sqrt(static_cast<double>(parameters.B2))) + 1;
+    auto const m0 = std::max(uint64_t { 1 }, parameters.B1 / D);
+    auto const m1 = parameters.B2 / D + 1;
+
+    auto const DQ = curve.ladder(Q, D).first;
+    auto [R, next] = curve.ladder(DQ, m0);
+
+    auto window = std::vector<bool>(D + 1);
+    auto accumulator = BigInt { 1 };
+
+    for (auto m = m0; m <= m1; m++) {
+        if (stop.stop_requested())
+            return {};
+
+        // Sieve [mD - D/2, mD + D/2] to find the primes in this giant step
+        auto const low = m * D - D / 2;
+        std::fill(window.begin(), window.end(), true);
+
+        for (auto i = 0uz; i < primes.size() && primes[i] <= root; i++) {
+            auto const p = static_cast<uint64_t>(primes[i]);
+            auto start = std::max(p * p, (low + p - 1) / p * p);
+
+            for (auto k = start; k <= low + D; k += p)
+                window[k - low] = false;
+        }
+
+        auto const is_prime = [&](uint64_t k) {
+            return k > parameters.B1 && k <= parameters.B2 && window[k - low];
+        };
+
+        for (auto const& [j, P] : baby)
+            if (is_prime(m * D - j) || is_prime(m * D + j))
+                accumulator = (accumulator * (R.x - P.x * R.z)) % n;
+
+        auto following = curve.add(next, DQ, R);
+        R = std::move(next);
+        next = std::move(following);
+    }
+
+    return nontrivial(gcd(accumulator, n), n);
+}
+}
+
+ECMParameters ECMParametersForDigits(size_t digits)
+{
+    // Optimal B1 and expected number of curves to find a factor of the given number of digits,
+    // taken from the GMP-ECM tables. The stage 2 here is a classical continuation rather than
+    // the FFT continuation, so B2 is set to 100 * B1.
+    // clang-format off
+    auto static constexpr table = std::array<std::pair<size_t, ECMParameters>, 12> { {
+        { 10, {         360,           36'000,      7 } },
+        { 15, {        2000,          200'000,     25 } },
+        { 20, {      11'000,        1'100'000,     90 } },
+        { 25, {      50'000,        5'000'000,    300 } },
+        { 30, {     250'000,       25'000'000,    700 } },
+        { 35, {   1'000'000,      100'000'000,   1800 } },
+        { 40, {   3'000'000,      300'000'000,   5100 } },
+        { 45, {  11'000'000,    1'100'000'000, 10'600 } },
+        { 50, {  43'000'000,    4'300'000'000, 19'300 } },
+        { 55, { 110'000'000,   11'000'000'000, 49'000 } },
+        { 60, { 260'000'000,   26'000'000'000, 124'000 } },
+        { 65, { 850'000'000,   85'000'000'000, 210'000 } },
+    } };
+    // clang-format on
+
+    for (auto const& [d, parameters] : table)
+        if (digits <= d)
+            return parameters;
+
+    return table.back().second;
+}
+
+std::optional<BigInt> ECM(BigInt const& n, ECMParameters const& parameters, size_t threads)
+{
+    // Lenstra's elliptic curve factorization using Montgomery curves with Suyama's parametrization.
+    // Curves are distributed across threads; the first thread to find a factor stops all others.
+    if (n <= 3)
+        return {};
+
+    if (n.bit_at(0) == 0)
+        return BigInt { 2 };
+
+    threads = HardwareThreads(threads);
+
+    auto const limit = static_cast<uint64_t>(std::sqrt(static_cast<double>(parameters.B2))) + 1;
+    auto const primes = SievePrimes(static_cast<uint32_t>(std::max(parameters.B1, limit)));
+
+    auto source = std::stop_source {};
+    auto curve = std::atomic<size_t> { 0 };
+    auto mutex = std::mutex {};
+    auto factor = std::optional<BigInt> {};
+
+    auto const worker = [&](std::stop_token stop) {
+        auto rd = std::random_device {};
+        auto e2 = std::mt19937_64 { rd() };
+        auto dist = std::uniform_int_distribution<uint64_t> { 6, 1ull << 32 };
+
+        while (!stop.stop_requested() && curve++ < parameters.curves) {
+            auto const d = ECMCurve(n, dist(e2), parameters, primes, stop);
+
+            if (!d)
+                continue;
+
+            auto lock = std::lock_guard { mutex };
+
+            if (!factor)
+                factor = d;
+
+            source.request_stop();
+        }
+    };
+
+    {
+        auto pool = std::vector<std::jthread> {};
+
+        for (auto i = 0uz; i < threads; i++)
+            pool.emplace_back([&] { worker(source.get_token()); });
+    }
+
+    return factor;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// Elliptic Curve Method
+struct ECMParameters {
+    uint64_t B1;   // Stage 1 bound; every prime power <= B1 is multiplied into the point
+    uint64_t B2;   // Stage 2 bound; a single extra prime in (B1, B2] is allowed
+    size_t curves; // Number of curves to try before giving up
+};
+
+ECMParameters ECMParametersForDigits(size_t digits);
+std::optional<BigInt> ECM(BigInt const& n, ECMParameters const& parameters, size_t threads = 0);
+
+// Self-initializing Quadratic Sieve
+std::optional<BigInt> QuadraticSieve(BigInt const& n, size_t threads = 0);
+
+// Batch GCD
+struct BatchGCDParameters {
+    size_t threads = 0;      // Worker threads per tree level, 0 uses all hardware threads
+    size_t memory_limit = 0; // Bytes of product tree above the moduli kept in memory before levels spill to disk, 0 is unlimited
+    std::filesystem::path spill_directory = std::filesystem::temp_directory_path();
+};
+
+std::vector<BigInt> BatchGCD(std::vector<BigInt> const& moduli, BatchGCDParameters const& parameters = {});
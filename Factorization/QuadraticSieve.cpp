@@ -0,0 +1,682 @@
+#include <Factorization/Factorization.h>
+#include <Modmath.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct SIQSParameters {
+    size_t digits;
+    size_t primes; // Size of the factor base
+    size_t blocks; // Sieve interval is [-M, M) with M = blocks * block_size
+};
+
+size_t constexpr block_size = 32768;   // Fits in L1/L2 data cache
+int64_t constexpr min_interval = 256;  // Smallest M tried when the interval is narrowed for small n
+uint32_t constexpr small_prime = 30;   // Primes below this are not sieved
+size_t constexpr max_failures = 16;    // Consecutive failures to find a new a before the workers stop
+double constexpr max_tolerance = 3;    // Widest window, in bits, around the size of the primes of a
+
+SIQSParameters const& ParametersForDigits(size_t digits)
+{
+    // clang-format off
+    auto static constexpr table = std::array<SIQSParameters, 10> { {
+        {  20,   120,  1 },
+        {  30,   250,  1 },
+        {  40,   550,  1 },
+        {  50,  1300,  2 },
+        {  60,  2700,  3 },
+        {  70,  5500,  4 },
+        {  80, 11000,  6 },
+        {  90, 22000,  8 },
+        { 100, 44000, 10 },
+        { 110, 70000, 12 },
+    } };
+    // clang-format on
+
+    for (auto const& parameters : table)
+        if (digits <= parameters.digits)
+            return parameters;
+
+    return table.back();
+}
+
+uint32_t KnuthSchroeppel(BigInt const& n, std::vector<uint32_t> const& primes)
+{
+    // Choose a small squarefree multiplier k such that kn has many small quadratic residues
+    // clang-format off
+    auto static constexpr multipliers = std::array<uint32_t, 31> {
+        1, 3, 5, 7, 11, 13, 15, 17, 19, 21, 23, 29, 31, 33, 35, 37, 39, 41, 43, 47, 51, 53, 55, 57, 59, 61, 65,
+        67, 69, 71, 73
+    };
+    // clang-format on
+
+    auto residues = std::vector<uint64_t> {};
+    for (auto p : primes)
+        residues.push_back((n % static_cast<uint64_t>(p)).to_uint64());
+
+    auto const n8 = (n % uint64_t { 8 }).to_uint64();
+
+    auto best = uint32_t { 1 };
+    auto best_score = -1e300;
+
+    for (auto k : multipliers) {
+        auto score = -0.5 * std::log(k);
+
+        switch ((n8 * k) % 8) {
+        case 1:
+            score += 2 * std::log(2);
+            break;
+        case 5:
+            score += std::log(2);
+            break;
+        default:
+            score += 0.5 * std::log(2);
+        }
+
+        for (auto i = 1uz; i < primes.size(); i++) {
+            auto const p = static_cast<uint64_t>(primes[i]);
+            auto const r = residues[i] * k % p;
+
+            if (k % p == 0)
+                score += std::log(p) / p;
+            else if (r && Jacobi64(r, p) == 1)
+                score += 2 * std::log(p) / (p - 1);
+        }
+
+        if (score > best_score) {
+            best_score = score;
+            best = k;
+        }
+    }
+
+    return best;
+}
+
+double log2(BigInt const& n)
+{
+    // Approximate base 2 logarithm from the leading 64 bits
+    auto const bits = static_cast<int>(n.size());
+
+    if (bits <= 64)
+        return std::log2(static_cast<double>(n.to_uint64()));
+
+    return std::log2(static_cast<double>((n >> (bits - 64)).to_uint64())) + (bits - 64);
+}
+
+struct FactorBasePrime {
+    uint32_t p;
+    uint32_t root; // sqrt(kN) mod p
+    uint8_t logp;
+};
+
+struct Relation {
+    // Y^2 = (-1)^e0 * prod p_i^e_i * large^2 (mod n)
+    BigInt Y;
+    std::vector<uint32_t> factors; // Factor base indices with multiplicity, 0 denotes -1
+    uint64_t large;                // Product of the paired large primes, 1 if none
+};
+
+class SIQS {
+private:
+    BigInt const& m_n;
+    BigInt m_kn;
+    std::vector<FactorBasePrime> m_base;
+    int64_t m_M;
+    uint64_t m_large_bound;
+    uint8_t m_threshold;
+
+    // Primes from which the coefficient a is built, within m_tolerance bits of the size that s of them need
+    std::vector<uint32_t> m_candidates;
+    size_t m_s;
+    double m_target;
+    double m_tolerance { 1 };
+
+    std::mutex m_mutex;
+    std::set<std::vector<uint32_t>> m_used;
+    std::vector<Relation> m_relations;
+    std::unordered_map<uint64_t, Relation> m_partials;
+    std::atomic<bool> m_done { false };
+    std::atomic<size_t> m_failures { 0 };
+
+    void choose_s();
+    bool choose_a(std::mt19937_64& e2, std::vector<uint32_t>& indices);
+    void sieve(std::mt19937_64& e2);
+    void add_relation(Relation relation);
+
+public:
+    SIQS(BigInt const& n, BigInt kn, std::vector<FactorBasePrime> base, int64_t M);
+
+    bool viable() const { return m_s > 0; }
+    bool widen();
+    bool run(size_t threads);
+    std::optional<BigInt> solve();
+};
+
+SIQS::SIQS(BigInt const& n, BigInt kn, std::vector<FactorBasePrime> base, int64_t M)
+    : m_n(n)
+    , m_kn(kn)
+    , m_base(base)
+    , m_M(M)
+    , m_s(0)
+{
+    auto const pmax = static_cast<uint64_t>(m_base.back().p);
+    m_large_bound = std::min(pmax * pmax, pmax * 64);
+
+    // |g(x)| ~ M sqrt(kN / 2) over the interval, allow for one large prime and the unsieved small primes
+    auto const size = std::log2(static_cast<double>(m_M)) + log2(m_kn) / 2 - 0.5;
+    m_threshold = static_cast<uint8_t>(std::max(0.0, size - std::log2(static_cast<double>(m_large_bound)) - 4));
+
+    // a ~ sqrt(2kN) / M is the product of s primes of roughly 2^11 chosen from the factor base
+    m_target = (log2(m_kn) + 1) / 2 - std::log2(static_cast<double>(m_M));
+
+    choose_s();
+}
+
+void SIQS::choose_s()
+{
+    auto const pmax = static_cast<uint64_t>(m_base.back().p);
+
+    m_s = 0;
+
+    for (auto s = std::clamp(static_cast<size_t>(std::lround(m_target / 11)), 2uz, 20uz); s >= 2 && s <= 20;) {
+        auto const bits = m_target / static_cast<double>(s);
+
+        m_candidates.clear();
+
+        for (auto i = 2uz; i < m_base.size(); i++) {
+            auto const lp = std::log2(static_cast<double>(m_base[i].p));
+
+            if (m_base[i].root != 0 && m_base[i].p > small_prime && std::abs(lp - bits) <= m_tolerance)
+                m_candidates.push_back(static_cast<uint32_t>(i));
+        }
+
+        if (m_candidates.size() >= 2 * s + 4) {
+            m_s = s;
+            break;
+        }
+
+        if (bits > std::log2(static_cast<double>(pmax)) - 1)
+            s++;
+        else
+            s--;
+    }
+}
+
+bool SIQS::widen()
+{
+    // Called once the distinct choices of a have run out: more candidates give more of them, and the
+    // relations collected so far are kept
+    while (m_tolerance < max_tolerance) {
+        m_tolerance += 0.5;
+        choose_s();
+
+        if (viable()) {
+            m_failures = 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SIQS::choose_a(std::mt19937_64& e2, std::vector<uint32_t>& indices)
+{
+    auto dist = std::uniform_int_distribution<size_t> { 0, m_candidates.size() - 1 };
+
+    for (auto attempt = 0; attempt < 64; attempt++) {
+        indices.clear();
+
+        auto bits = 0.0;
+        while (indices.size() < m_s - 1) {
+            auto const i = m_candidates[dist(e2)];
+
+            if (std::find(indices.begin(), indices.end(), i) != indices.end())
+                continue;
+
+            indices.push_back(i);
+            bits += std::log2(static_cast<double>(m_base[i].p));
+        }
+
+        // Pick the last prime to bring a as close to the target as possible
+        auto best = uint32_t { 0 };
+        auto best_error = 1e300;
+
+        for (auto i : m_candidates) {
+            if (std::find(indices.begin(), indices.end(), i) != indices.end())
+                continue;
+
+            auto const error = std::abs(bits + std::log2(static_cast<double>(m_base[i].p)) - m_target);
+
+            if (error < best_error) {
+                best_error = error;
+                best = i;
+            }
+        }
+
+        indices.push_back(best);
+        std::sort(indices.begin(), indices.end());
+
+        auto lock = std::lock_guard { m_mutex };
+
+        if (m_used.insert(indices).second)
+            return true;
+    }
+
+    return false;
+}
+
+void SIQS::add_relation(Relation relation)
+{
+    auto lock = std::lock_guard { m_mutex };
+
+    if (m_done)
+        return;
+
+    if (relation.large == 1) {
+        m_relations.push_back(std::move(relation));
+    } else {
+        // Large prime variation: two partial relations sharing a large prime combine into a full one
+        auto const it = m_partials.find(relation.large);
+
+        if (it == m_partials.end()) {
+            m_partials.emplace(relation.large, std::move(relation));
+            return;
+        }
+
+        auto& other = it->second;
+
+        if (other.Y == relation.Y)
+            return;
+
+        relation.Y = (relation.Y * other.Y) % m_n;
+        relation.factors.insert(relation.factors.end(), other.factors.begin(), other.factors.end());
+        m_relations.push_back(std::move(relation));
+    }
+
+    if (m_relations.size() >= m_base.size() + 64)
+        m_done = true;
+}
+
+void SIQS::sieve(std::mt19937_64& e2)
+{
+    // Generate a new coefficient a and sieve all 2^(s-1) polynomials g(x) = ax^2 + 2bx + c belonging to it,
+    // where (ax + b)^2 - kN = a g(x)
+    auto indices = std::vector<uint32_t> {};
+
+    if (!choose_a(e2, indices)) {
+        m_failures++;
+        return;
+    }
+
+    m_failures = 0;
+
+    auto const F = m_base.size();
+    auto const s = m_s;
+
+    auto a = BigInt { 1 };
+    for (auto i : indices)
+        a *= static_cast<uint64_t>(m_base[i].p);
+
+    auto in_a = std::vector<bool>(F);
+    for (auto i : indices)
+        in_a[i] = true;
+
+    // B_l = (a / q_l) * (t_l * (a / q_l)^-1 mod q_l) so that b = sum B_l satisfies b^2 = kN (mod a)
+    auto B = std::vector<BigInt>(s);
+    auto b = BigInt {};
+
+    for (auto l = 0uz; l < s; l++) {
+        auto const q = static_cast<uint64_t>(m_base[indices[l]].p);
+        auto const aq = a / q;
+        auto gamma = m_base[indices[l]].root * Modinv64((aq % q).to_uint64(), q) % q;
+
+        if (gamma > q / 2)
+            gamma = q - gamma;
+
+        B[l] = aq * gamma;
+        b += B[l];
+    }
+
+    // Roots of g(x) mod p for every sieved prime, and the per B_l corrections for the Gray code walk
+    auto soln1 = std::vector<uint32_t>(F);
+    auto soln2 = std::vector<uint32_t>(F);
+    auto Bainv2 = std::vector<std::vector<uint32_t>>(s, std::vector<uint32_t>(F));
+
+    for (auto i = 2uz; i < F; i++) {
+        if (in_a[i])
+            continue;
+
+        auto const p = static_cast<uint64_t>(m_base[i].p);
+        auto const ainv = Modinv64((a % p).to_uint64(), p);
+        auto const bp = (b % p).to_uint64();
+        auto const t = static_cast<uint64_t>(m_base[i].root);
+
+        soln1[i] = static_cast<uint32_t>(ainv * ((t + p - bp) % p) % p);
+        soln2[i] = static_cast<uint32_t>(ainv * ((2 * p - t - bp) % p) % p);
+
+        for (auto l = 0uz; l < s; l++)
+            Bainv2[l][i] = static_cast<uint32_t>(2 * (B[l] % p).to_uint64() % p * ainv % p);
+    }
+
+    auto sieve = std::vector<uint8_t>(block_size);
+    auto offset1 = std::vector<uint32_t>(F);
+    auto offset2 = std::vector<uint32_t>(F);
+
+    auto first = 2uz;
+    while (first < F && m_base[first].p < small_prime)
+        first++;
+
+    for (auto poly = 0uz; poly < (1uz << (s - 1)); poly++) {
+        if (m_done)
+            return;
+
+        if (poly) {
+            // Gray code step: b <- b + 2 (-1)^ceil(poly / 2^(v + 1)) B_v
+            auto const v = static_cast<size_t>(__builtin_ctzll(poly));
+            auto const negative = ((poly >> (v + 1)) + ((poly & ((2ull << v) - 1)) != 0)) & 1;
+
+            if (negative)
+                b -= B[v] * 2;
+            else
+                b += B[v] * 2;
+
+            for (auto i = 2uz; i < F; i++) {
+                if (in_a[i])
+                    continue;
+
+                auto const p = m_base[i].p;
+                auto const delta = Bainv2[v][i];
+
+                if (negative) {
+                    soln1[i] = (soln1[i] + delta) % p;
+                    soln2[i] = (soln2[i] + delta) % p;
+                } else {
+                    soln1[i] = (soln1[i] + p - delta) % p;
+                    soln2[i] = (soln2[i] + p - delta) % p;
+                }
+            }
+        }
+
+        auto const c = (b * b - m_kn) / a;
+
+        for (auto i = first; i < F; i++) {
+            if (in_a[i])
+                continue;
+
+            auto const p = static_cast<int64_t>(m_base[i].p);
+            auto const shift = m_M % p;
+
+            offset1[i] = static_cast<uint32_t>((soln1[i] + shift) % p);
+            offset2[i] = static_cast<uint32_t>((soln2[i] + shift) % p);
+        }
+
+        for (auto start = -m_M; start < m_M; start += block_size) {
+            // The last block is partial when the interval is narrower than a block
+            auto const length = static_cast<uint32_t>(std::min(static_cast<int64_t>(block_size), m_M - start));
+            std::fill(sieve.begin(), sieve.end(), 0);
+
+            for (auto i = first; i < F; i++) {
+                if (in_a[i])
+                    continue;
+
+                auto const p = m_base[i].p;
+                auto const logp = m_base[i].logp;
+
+                auto pos = offset1[i];
+                for (; pos < length; pos += p)
+                    sieve[pos] += logp;
+                offset1[i] = pos - length;
+
+                if (soln1[i] == soln2[i])
+                    continue;
+
+                pos = offset2[i];
+                for (; pos < length; pos += p)
+                    sieve[pos] += logp;
+                offset2[i] = pos - length;
+            }
+
+            for (auto j = 0u; j < length; j++) {
+                if (sieve[j] < m_threshold)
+                    continue;
+
+                // Trial divide g(x), using the known roots to skip primes that cannot divide it
+                auto const x = start + static_cast<int64_t>(j);
+                auto g = (a * BigInt { x } + b * 2) * BigInt { x } + c;
+
+                if (g.is_zero())
+                    continue;
+
+                auto relation = Relation { a * BigInt { x } + b, {}, 1 };
+
+                if (g.is_negative()) {
+                    relation.factors.push_back(0);
+                    g = -g;
+                }
+
+                for (auto k = g.trailing_zeros(); k-- > 0;)
+                    relation.factors.push_back(1);
+
+                g >>= static_cast<int>(g.trailing_zeros());
+                relation.factors.insert(relation.factors.end(), indices.begin(), indices.end());
+
+                for (auto i = 2uz; i < F; i++) {
+                    auto const p = static_cast<uint64_t>(m_base[i].p);
+                    auto const xp = static_cast<uint64_t>(((x % static_cast<int64_t>(p)) + static_cast<int64_t>(p)) % static_cast<int64_t>(p));
+
+                    if (!in_a[i] && xp != soln1[i] && xp != soln2[i])
+                        continue;
+
+                    while ((g % p).is_zero()) {
+                        g /= p;
+                        relation.factors.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+
+                if (g == 1) {
+                    add_relation(std::move(relation));
+                } else if (g.size() <= 64 && g.to_uint64() < m_large_bound) {
+                    relation.large = g.to_uint64();
+                    add_relation(std::move(relation));
+                }
+            }
+        }
+    }
+}
+
+bool SIQS::run(size_t threads)
+{
+    // Sieves until there are enough relations, or until the workers keep failing to find a new a.
+    // Returns whether there are enough relations.
+    auto const worker = [&] {
+        auto rd = std::random_device {};
+        auto e2 = std::mt19937_64 { rd() };
+
+        while (!m_done && m_failures < max_failures)
+            sieve(e2);
+    };
+
+    {
+        auto pool = std::vector<std::jthread> {};
+
+        for (auto i = 0uz; i < threads; i++)
+            pool.emplace_back(worker);
+    }
+
+    return m_done;
+}
+
+std::optional<BigInt> SIQS::solve()
+{
+    // Gaussian elimination over GF(2) on the exponent parity vectors. The history of each row is kept
+    // so that the rows reduced to zero give the dependencies.
+    auto const R = m_relations.size();
+    auto const C = m_base.size();
+    auto const cwords = (C + 63) / 64;
+    auto const rwords = (R + 63) / 64;
+
+    auto matrix = std::vector<std::vector<uint64_t>>(R, std::vector<uint64_t>(cwords));
+    auto history = std::vector<std::vector<uint64_t>>(R, std::vector<uint64_t>(rwords));
+
+    for (auto i = 0uz; i < R; i++) {
+        for (auto f : m_relations[i].factors)
+            matrix[i][f / 64] ^= 1ull << (f % 64);
+
+        history[i][i / 64] |= 1ull << (i % 64);
+    }
+
+    auto rank = 0uz;
+
+    for (auto c = 0uz; c < C && rank < R; c++) {
+        auto const word = c / 64;
+        auto const bit = 1ull << (c % 64);
+
+        auto pivot = rank;
+        while (pivot < R && !(matrix[pivot][word] & bit))
+            pivot++;
+
+        if (pivot == R)
+            continue;
+
+        std::swap(matrix[pivot], matrix[rank]);
+        std::swap(history[pivot], history[rank]);
+
+        for (auto r = rank + 1; r < R; r++) {
+            if (!(matrix[r][word] & bit))
+                continue;
+
+            for (auto w = word; w < cwords; w++)
+                matrix[r][w] ^= matrix[rank][w];
+
+            for (auto w = 0uz; w < rwords; w++)
+                history[r][w] ^= history[rank][w];
+        }
+
+        rank++;
+    }
+
+    // Each dependency gives X^2 = Z^2 (mod n); a nontrivial gcd(X - Z, n) splits n
+    for (auto r = rank; r < R; r++) {
+        auto X = BigInt { 1 };
+        auto Z = BigInt { 1 };
+        auto exponents = std::vector<uint32_t>(C);
+
+        for (auto i = 0uz; i < R; i++) {
+            if (!(history[r][i / 64] & (1ull << (i % 64))))
+                continue;
+
+            auto const& relation = m_relations[i];
+
+            X = (X * relation.Y) % m_n;
+            Z = (Z * static_cast<uint64_t>(relation.large)) % m_n;
+
+            for (auto f : relation.factors)
+                exponents[f]++;
+        }
+
+        for (auto i = 1uz; i < C; i++)
+            for (auto e = 0u; e < exponents[i] / 2; e++)
+                Z = (Z * static_cast<uint64_t>(m_base[i].p)) % m_n;
+
+        auto const d = gcd(X - Z, m_n);
+
+        if (d != 1 && d != m_n)
+            return d;
+    }
+
+    return {};
+}
+
+std::optional<BigInt> Fallback(BigInt const& n, size_t digits, size_t threads)
+{
+    // ECM for the composites the sieve did not split, sized for a factor of half their digits. The curves
+    // are retried rather than the bound raised: with a small n a larger B1 more often catches both factors
+    // at once, and gcd = n splits nothing.
+    if (!MillerRabin(n))
+        return {};
+
+    auto const parameters = ECMParametersForDigits((digits + 1) / 2);
+
+    while (true)
+        if (auto const factor = ECM(n, parameters, threads))
+            return factor;
+}
+}
+
+std::optional<BigInt> QuadraticSieve(BigInt const& n, size_t threads)
+{
+    // Self-initializing quadratic sieve (Contini), finds a nontrivial factor of a composite n
+    if (n <= 3)
+        return {};
+
+    if (n.bit_at(0) == 0)
+        return BigInt { 2 };
+
+    if (auto const root = Isqrt(n); root * root == n)
+        return root;
+
+    threads = HardwareThreads(threads);
+
+    auto const digits = static_cast<size_t>(n.size() * 0.30103) + 1;
+    auto const& parameters = ParametersForDigits(digits);
+
+    auto primes = SievePrimes(1000);
+    auto const k = KnuthSchroeppel(n, primes);
+    auto const kn = n * static_cast<uint64_t>(k);
+
+    // Factor base: -1, 2, and the odd primes p for which kN is a quadratic residue
+    auto base = std::vector<FactorBasePrime> { { 1, 0, 0 }, { 2, 1, 1 } };
+
+    for (auto limit = static_cast<uint32_t>(parameters.primes * 32); base.size() < parameters.primes; limit *= 2) {
+        primes = SievePrimes(limit);
+        base.resize(2);
+
+        for (auto i = 1uz; i < primes.size() && base.size() < parameters.primes; i++) {
+            auto const p = static_cast<uint64_t>(primes[i]);
+            auto const r = (kn % p).to_uint64();
+            auto const logp = static_cast<uint8_t>(std::lround(std::log2(static_cast<double>(p))));
+
+            if (r == 0) {
+                if (k % p)
+                    return BigInt { static_cast<int64_t>(p) };
+
+                base.push_back({ static_cast<uint32_t>(p), 0, logp });
+            } else if (auto const root = Modsqrt64(r, p)) {
+                base.push_back({ static_cast<uint32_t>(p), static_cast<uint32_t>(*root), logp });
+            }
+        }
+    }
+
+    // A narrower interval asks for a larger a, whose primes are more plentiful in a small factor base
+    auto siqs = std::optional<SIQS> {};
+
+    for (auto M = static_cast<int64_t>(parameters.blocks * block_size);; M /= 2) {
+        siqs.emplace(n, kn, base, M);
+
+        if (siqs->viable() || M <= min_interval)
+            break;
+    }
+
+    if (!siqs->viable())
+        return Fallback(n, digits, threads);
+
+    while (!siqs->run(threads))
+        if (!siqs->widen())
+            return Fallback(n, digits, threads);
+
+    if (auto const factor = siqs->solve())
+        return factor;
+
+    return Fallback(n, digits, threads);
+}
@@ -0,0 +1,160 @@
+#include <Hash/FileHash.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+size_t constexpr window = 64uz << 20; // Bytes HashFile reads ahead of the hashing
+
+class MappedFile {
+    // Read-only mapping of a whole file, unmapped on destruction. Pages are read in on first access, and
+    // dropped from the mapping again with release(); they stay in the page cache.
+private:
+    std::byte const* m_data { nullptr };
+    size_t m_size { 0 };
+
+    static inline size_t page_size() { return static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
+
+    void advise(size_t offset, size_t size, int advice) const
+    {
+        // madvise wants a page-aligned start, so the range grows to the whole pages it touches
+        auto const begin = offset / page_size() * page_size();
+        auto const end = std::min(offset + size, m_size);
+
+        if (begin < end)
+            madvise(const_cast<std::byte*>(m_data) + begin, end - begin, advice);
+    }
+
+public:
+    MappedFile(std::filesystem::path const& path)
+    {
+        auto const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+            throw new std::runtime_error("[FileHash] Unable to open file");
+
+        struct stat info { };
+
+        if (fstat(fd, &info) < 0) {
+            close(fd);
+            throw new std::runtime_error("[FileHash] Unable to read file size");
+        }
+
+        m_size = static_cast<size_t>(info.st_size);
+
+        // An empty file cannot be mapped, and has nothing to map
+        auto* address = m_size ? mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+        close(fd);
+
+        if (address == MAP_FAILED)
+            throw new std::runtime_error("[FileHash] Unable to map file");
+
+        m_data = static_cast<std::byte const*>(address);
+    }
+
+    ~MappedFile()
+    {
+        if (m_size)
+            munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    inline std::span<std::byte const> get_data() const { return { m_data, m_size }; }
+
+    inline void sequential() const { advise(0, m_size, MADV_SEQUENTIAL); }
+    inline void prefetch(size_t offset, size_t size) const { advise(offset, size, MADV_WILLNEED); }
+    inline void release(size_t offset, size_t size) const { advise(offset, size, MADV_DONTNEED); }
+};
+
+template<typename F>
+Sha256::Digest Tree(std::span<std::byte const> data, TreeHashParameters const& parameters, F&& hashed)
+{
+    // Leaves in parallel, calling hashed(offset, size) after each chunk, then the levels above them
+    auto const chunk_size = parameters.chunk_size;
+
+    if (!chunk_size)
+        throw new std::runtime_error("[TreeHash] Chunk size must be positive");
+
+    auto const leaves = std::max(1uz, (data.size() + chunk_size - 1) / chunk_size);
+    auto level = std::vector<Sha256::Digest>(leaves);
+
+    ParallelFor(leaves, parameters.threads, [&](size_t i) {
+        auto const offset = i * chunk_size;
+        auto const chunk = data.subspan(offset, std::min(chunk_size, data.size() - offset));
+        auto const prefix = std::array<uint8_t, 1> { 0x00 };
+
+        level[i] = Sha256 {}.update(prefix).update(chunk).final();
+        hashed(offset, chunk.size());
+    });
+
+    // One leaf per chunk leaves few enough nodes above them to be hashed on this thread, a level at a time
+    // as independent messages across the lanes of the multi-message hash
+    using Node = std::array<uint8_t, 1 + 2 * sizeof(Sha256::Digest)>;
+
+    while (level.size() > 1) {
+        auto nodes = std::vector<Node>(level.size() / 2);
+        auto messages = std::vector<std::span<std::byte const>>(nodes.size());
+
+        for (auto i = 0uz; i < nodes.size(); i++) {
+            nodes[i][0] = 0x01;
+            std::ranges::copy(level[2 * i], nodes[i].begin() + 1);
+            std::ranges::copy(level[2 * i + 1], nodes[i].begin() + 1 + sizeof(Sha256::Digest));
+            messages[i] = std::as_bytes(std::span(nodes[i]));
+        }
+
+        auto parents = Sha256::hash(std::span<std::span<std::byte const> const>(messages));
+
+        if (level.size() & 1)
+            parents.push_back(level.back());
+
+        level = std::move(parents);
+    }
+
+    return level[0];
+}
+}
+
+Sha256::Digest HashFile(std::filesystem::path const& path)
+{
+    // One window at a time: the next one is read in while this one is hashed, and the pages already hashed
+    // are released, holding the resident size to about two windows for any file size
+    auto const file = MappedFile { path };
+    auto const data = file.get_data();
+    auto context = Sha256 {};
+
+    file.sequential();
+    file.prefetch(0, window);
+
+    for (auto offset = 0uz; offset < data.size(); offset += window) {
+        auto const size = std::min(window, data.size() - offset);
+
+        file.prefetch(offset + window, window);
+        context.update(data.subspan(offset, size));
+        file.release(offset, size);
+    }
+
+    return context.final();
+}
+
+Sha256::Digest TreeHash(std::span<std::byte const> data, TreeHashParameters const& parameters)
+{
+    return Tree(data, parameters, [](size_t, size_t) { });
+}
+
+Sha256::Digest TreeHashFile(std::filesystem::path const& path, TreeHashParameters const& parameters)
+{
+    // Threads fault in their own chunks, with the kernel's readahead following each of them
+    auto const file = MappedFile { path };
+
+    return Tree(file.get_data(), parameters, [&](size_t offset, size_t size) { file.release(offset, size); });
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Hash/SHA.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// Merkle tree over fixed-size chunks, hashed in parallel
+struct TreeHashParameters {
+    size_t threads = 0;          // Worker threads, 0 uses all hardware threads
+    size_t chunk_size = 1 << 20; // Bytes per leaf, the last chunk may be shorter
+};
+
+// The standard SHA-256 of the file, streamed through a memory mapping
+Sha256::Digest HashFile(std::filesystem::path const& path);
+
+// Root of the tree with leaves SHA-256(0x00 || chunk) and nodes SHA-256(0x01 || left || right), a node without
+// a sibling moving up a level unchanged (RFC 6962 2.1). An empty input is a single empty leaf. Not the SHA-256
+// of the input, but the same for a given chunk size regardless of the number of threads.
+Sha256::Digest TreeHash(std::span<std::byte const> data, TreeHashParameters const& parameters = {});
+Sha256::Digest TreeHashFile(std::filesystem::path const& path, TreeHashParameters const& parameters = {});
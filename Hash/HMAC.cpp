@@ -0,0 +1,247 @@
+#include <Hash/HMAC.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace {
+template<class Hash>
+using Block = std::array<uint8_t, Hash::block_size>;
+
+template<class Hash>
+Block<Hash> KeyBlock(std::span<uint8_t const> key)
+{
+    // The key zero-padded to a block, hashed first when longer than one
+    auto block = Block<Hash> {};
+
+    if (key.size() > Hash::block_size)
+        std::ranges::copy(Hash::hash(key), block.begin());
+    else
+        std::ranges::copy(key, block.begin());
+
+    return block;
+}
+
+template<class Hash>
+Block<Hash> Xor(Block<Hash> block, uint8_t pad)
+{
+    for (auto& byte : block)
+        byte ^= pad;
+
+    return block;
+}
+
+template<class Hash>
+void PadDigest(Block<Hash>& block)
+{
+    // The padding of a message of one block and one digest, the digest itself going in front of it
+    auto constexpr digest_size = sizeof(typename Hash::Digest);
+    auto const bits = uint64_t { 8 * (Hash::block_size + digest_size) };
+
+    block.fill(0);
+    block[digest_size] = 0x80;
+
+    for (auto i = 0uz; i < 8; i++)
+        block[Hash::block_size - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+}
+}
+
+template<class Hash>
+Hmac<Hash>::Hmac(std::span<uint8_t const> key)
+{
+    auto const block = KeyBlock<Hash>(key);
+
+    m_inner_key.update(Xor<Hash>(block, 0x36));
+    m_outer_key.update(Xor<Hash>(block, 0x5c));
+    m_inner = m_inner_key;
+}
+
+template<class Hash>
+Hmac<Hash>& Hmac<Hash>::update(std::span<std::byte const> data)
+{
+    m_inner.update(data);
+
+    return *this;
+}
+
+template<class Hash>
+Hmac<Hash>& Hmac<Hash>::update(std::span<uint8_t const> data) { return update(std::as_bytes(data)); }
+
+template<class Hash>
+typename Hmac<Hash>::Digest Hmac<Hash>::final()
+{
+    auto const digest = m_inner.final();
+    auto outer = m_outer_key;
+
+    m_inner = m_inner_key;
+
+    return outer.update(digest).final();
+}
+
+template<class Hash>
+typename Hmac<Hash>::Digest Hmac<Hash>::mac(std::span<uint8_t const> key, std::span<uint8_t const> message)
+{
+    return Hmac(key).update(message).final();
+}
+
+template<class Hash>
+std::pair<typename Hash::State, typename Hash::State> Hmac<Hash>::key_states(std::span<uint8_t const> key)
+{
+    auto const block = KeyBlock<Hash>(key);
+    auto const inner_block = Xor<Hash>(block, 0x36);
+    auto const outer_block = Xor<Hash>(block, 0x5c);
+
+    auto inner = Hash::initial_state;
+    auto outer = Hash::initial_state;
+
+    Hash::compress(inner, std::as_bytes(std::span(inner_block)));
+    Hash::compress(outer, std::as_bytes(std::span(outer_block)));
+
+    return { inner, outer };
+}
+
+template<class Hash>
+typename Hash::Digest HkdfExtract(std::span<uint8_t const> salt, std::span<uint8_t const> ikm)
+{
+    // No salt is a key of zeros, which the key block already pads it to
+    return Hmac<Hash>::mac(salt, ikm);
+}
+
+template<class Hash>
+std::vector<uint8_t> HkdfExpand(std::span<uint8_t const> prk, std::span<uint8_t const> info, size_t length)
+{
+    auto constexpr digest_size = sizeof(typename Hash::Digest);
+
+    if (length > 255 * digest_size)
+        throw new std::runtime_error("[HKDF] Output is limited to 255 digests");
+
+    auto hmac = Hmac<Hash>(prk);
+    auto okm = std::vector<uint8_t> {};
+    auto t = typename Hash::Digest {};
+
+    // T(i) = HMAC(PRK, T(i - 1) | info | i), T(0) empty
+    for (auto i = 1uz; okm.size() < length; i++) {
+        auto const counter = std::array<uint8_t, 1> { static_cast<uint8_t>(i) };
+
+        if (i > 1)
+            hmac.update(t);
+
+        t = hmac.update(info).update(counter).final();
+        okm.insert(okm.end(), t.begin(), t.begin() + static_cast<ptrdiff_t>(std::min(digest_size, length - okm.size())));
+    }
+
+    return okm;
+}
+
+template<class Hash>
+std::vector<uint8_t> Hkdf(std::span<uint8_t const> salt, std::span<uint8_t const> ikm, std::span<uint8_t const> info, size_t length)
+{
+    return HkdfExpand<Hash>(HkdfExtract<Hash>(salt, ikm), info, length);
+}
+
+template<class Hash>
+std::vector<uint8_t> Pbkdf2(std::span<uint8_t const> password, std::span<uint8_t const> salt, uint64_t iterations, size_t length)
+{
+    auto const passwords = std::array<std::span<uint8_t const>, 1> { password };
+
+    return Pbkdf2<Hash>(passwords, salt, iterations, length)[0];
+}
+
+template<class Hash>
+std::vector<std::vector<uint8_t>> Pbkdf2(std::span<std::span<uint8_t const> const> passwords, std::span<uint8_t const> salt,
+                                         uint64_t iterations, size_t length, size_t threads)
+{
+    using State = typename Hash::State;
+    using Digest = typename Hash::Digest;
+
+    auto constexpr digest_size = sizeof(Digest);
+
+    if (!iterations)
+        throw new std::runtime_error("[PBKDF2] At least one iteration is needed");
+
+    auto const blocks = (length + digest_size - 1) / digest_size;
+
+    if (blocks > 0xffffffff)
+        throw new std::runtime_error("[PBKDF2] Derived key too long");
+
+    auto keys = std::vector<std::pair<State, State>>(passwords.size());
+    auto derived = std::vector<std::vector<uint8_t>>(passwords.size(), std::vector<uint8_t>(length));
+
+    for (auto i = 0uz; i < passwords.size(); i++)
+        keys[i] = Hmac<Hash>::key_states(passwords[i]);
+
+    // Chain c computes output block c % blocks + 1 of password c / blocks. U_1 has the salt in it and is an
+    // ordinary HMAC; every later U_i is HMAC of the previous digest, one padded block for the inner hash from
+    // the inner key state and one for the outer hash from the outer key state, updated in place.
+    auto const chains = passwords.size() * blocks;
+    auto const group = Hash::get_lanes();
+
+    ParallelFor((chains + group - 1) / group, threads, [&](size_t index) {
+        auto const first = index * group;
+        auto const count = std::min(group, chains - first);
+
+        auto states = std::vector<State>(count);
+        auto messages = std::vector<Block<Hash>>(count);
+        auto pointers = std::vector<std::byte const*>(count);
+        auto sums = std::vector<Digest>(count);
+
+        for (auto c = 0uz; c < count; c++) {
+            auto const password = (first + c) / blocks;
+            auto const number = static_cast<uint32_t>((first + c) % blocks + 1);
+            auto const counter = std::array<uint8_t, 4> { static_cast<uint8_t>(number >> 24), static_cast<uint8_t>(number >> 16),
+                                                          static_cast<uint8_t>(number >> 8), static_cast<uint8_t>(number) };
+
+            sums[c] = Hmac<Hash>(passwords[password]).update(salt).update(counter).final();
+
+            PadDigest<Hash>(messages[c]);
+            std::ranges::copy(sums[c], messages[c].begin());
+            pointers[c] = reinterpret_cast<std::byte const*>(messages[c].data());
+        }
+
+        auto const step = [&](auto key) {
+            for (auto c = 0uz; c < count; c++)
+                states[c] = key(keys[(first + c) / blocks]);
+
+            Hash::compress(states, pointers);
+
+            for (auto c = 0uz; c < count; c++)
+                std::ranges::copy(Hash::to_digest(states[c]), messages[c].begin());
+        };
+
+        for (auto i = 1uz; i < iterations; i++) {
+            step([](auto const& key) { return key.first; });
+            step([](auto const& key) { return key.second; });
+
+            for (auto c = 0uz; c < count; c++)
+                for (auto j = 0uz; j < digest_size; j++)
+                    sums[c][j] ^= messages[c][j];
+        }
+
+        for (auto c = 0uz; c < count; c++) {
+            auto const offset = (first + c) % blocks * digest_size;
+            auto const size = std::min(digest_size, length - offset);
+
+            std::copy_n(sums[c].begin(), size, derived[(first + c) / blocks].begin() + static_cast<ptrdiff_t>(offset));
+        }
+    });
+
+    return derived;
+}
+
+#define INSTANTIATE(Hash)                                                                                                            \
+    template class Hmac<Hash>;                                                                                                       \
+    template Hash::Digest HkdfExtract<Hash>(std::span<uint8_t const>, std::span<uint8_t const>);                                     \
+    template std::vector<uint8_t> HkdfExpand<Hash>(std::span<uint8_t const>, std::span<uint8_t const>, size_t);                      \
+    template std::vector<uint8_t> Hkdf<Hash>(std::span<uint8_t const>, std::span<uint8_t const>, std::span<uint8_t const>, size_t); \
+    template std::vector<uint8_t> Pbkdf2<Hash>(std::span<uint8_t const>, std::span<uint8_t const>, uint64_t, size_t);               \
+    template std::vector<std::vector<uint8_t>> Pbkdf2<Hash>(std::span<std::span<uint8_t const> const>, std::span<uint8_t const>,    \
+                                                            uint64_t, size_t, size_t);
+
+INSTANTIATE(Sha224)
+INSTANTIATE(Sha256)
+INSTANTIATE(Sha384)
+INSTANTIATE(Sha512)
+INSTANTIATE(Sha512_256)
+
+#undef INSTANTIATE
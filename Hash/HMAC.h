@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Hash/SHA.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+template<class Hash>
+class Hmac {
+    /**
+     * HMAC (RFC 2104) over a hash of the SHA-2 family
+     * The key is absorbed once, into copies of the hash that have consumed the inner and the outer padded key
+     * blocks. Every message then starts from those states, so a MAC costs the compressions of the message and
+     * one more for the outer hash, however long the key.
+     */
+public:
+    using Digest = typename Hash::Digest;
+
+private:
+    Hash m_inner_key; // After key ^ ipad
+    Hash m_outer_key; // After key ^ opad
+    Hash m_inner;
+
+public:
+    Hmac(std::span<uint8_t const> key);
+
+    Hmac& update(std::span<std::byte const> data);
+    Hmac& update(std::span<uint8_t const> data);
+
+    // The MAC of the message so far, the context starts over with the same key afterwards
+    Digest final();
+
+    static Digest mac(std::span<uint8_t const> key, std::span<uint8_t const> message);
+
+    // The states after the padded key blocks, for constructions that hash many short messages under one key
+    static std::pair<typename Hash::State, typename Hash::State> key_states(std::span<uint8_t const> key);
+};
+
+// HKDF (RFC 5869): a pseudorandom key from input keying material, then length bytes of output keying material
+template<class Hash>
+typename Hash::Digest HkdfExtract(std::span<uint8_t const> salt, std::span<uint8_t const> ikm);
+
+template<class Hash>
+std::vector<uint8_t> HkdfExpand(std::span<uint8_t const> prk, std::span<uint8_t const> info, size_t length);
+
+template<class Hash>
+std::vector<uint8_t> Hkdf(std::span<uint8_t const> salt, std::span<uint8_t const> ikm, std::span<uint8_t const> info, size_t length);
+
+// PBKDF2 (RFC 8018 5.2) with HMAC. The iterations run from the key states, two compressions each, and every
+// output block of every password is an independent chain: chains are stepped together across the lanes of
+// the multi-message hash, and groups of chains are spread over threads (0 uses all hardware threads).
+template<class Hash>
+std::vector<uint8_t> Pbkdf2(std::span<uint8_t const> password, std::span<uint8_t const> salt, uint64_t iterations, size_t length);
+
+template<class Hash>
+std::vector<std::vector<uint8_t>> Pbkdf2(std::span<std::span<uint8_t const> const> passwords, std::span<uint8_t const> salt,
+                                         uint64_t iterations, size_t length, size_t threads = 0);
+
+using HmacSha256 = Hmac<Sha256>;
@@ -0,0 +1,722 @@
+#include <Hash/SHA.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+using SHA2::Engine32;
+using SHA2::Engine64;
+
+template<class Word>
+inline Word LoadBigEndian(uint8_t const* bytes)
+{
+    auto word = Word {};
+    std::memcpy(&word, bytes, sizeof(word));
+
+    return std::endian::native == std::endian::big ? word : std::byteswap(word);
+}
+
+template<size_t BlockSize>
+size_t Pad(std::array<uint8_t, 2 * BlockSize>& tail, uint8_t const* rest, size_t size, uint64_t length)
+{
+    // The last size < BlockSize bytes of a message of length bytes, a one bit, zeros, then the length in bits
+    // as a big-endian integer of an eighth of a block. Returns the number of blocks in tail, one or two.
+    auto constexpr field = BlockSize / 8;
+    auto const blocks = size < BlockSize - field ? 1uz : 2uz;
+    auto const end = tail.data() + blocks * BlockSize;
+
+    auto const low = length << 3;
+    auto const high = length >> 61;
+    auto const big_endian = std::endian::native == std::endian::big ? low : std::byteswap(low);
+
+    std::memcpy(tail.data(), rest, size);
+    tail[size] = 0x80;
+    std::memcpy(end - 8, &big_endian, sizeof(big_endian));
+
+    if constexpr (field > 8)
+        end[-9] = static_cast<uint8_t>(high);
+
+    return blocks;
+}
+
+template<class Parameters>
+typename Sha2<Parameters>::Digest ToDigest(std::array<typename Parameters::Word, 8> const& state)
+{
+    using Word = typename Parameters::Word;
+
+    auto bytes = std::array<uint8_t, 8 * sizeof(Word)> {};
+    auto digest = typename Sha2<Parameters>::Digest {};
+
+    for (auto i = 0uz; i < 8; i++) {
+        auto const word = std::endian::native == std::endian::big ? state[i] : std::byteswap(state[i]);
+        std::memcpy(bytes.data() + sizeof(Word) * i, &word, sizeof(word));
+    }
+
+    std::copy_n(bytes.begin(), digest.size(), digest.begin());
+
+    return digest;
+}
+
+template<class Engine, size_t J>
+__attribute__((always_inline)) inline void Round(std::array<typename Engine::Word, 8>& s, typename Engine::Word wk)
+{
+    // Round J on the working variables rotated by J, so that no values move between rounds. wk is W[J] + K[J].
+    auto const at = [&](size_t i) -> typename Engine::Word& { return s[(i - J) & 7]; };
+    auto constexpr& S0 = Engine::big_sigma0;
+    auto constexpr& S1 = Engine::big_sigma1;
+
+    auto const a = at(0);
+    auto const e = at(4);
+    auto const temp1 = at(7) + wk
+                       + (at(6) ^ (e & (at(5) ^ at(6))))
+                       + (std::rotr(e, S1[0]) ^ std::rotr(e, S1[1]) ^ std::rotr(e, S1[2]));
+    auto const temp2 = (std::rotr(a, S0[0]) ^ std::rotr(a, S0[1]) ^ std::rotr(a, S0[2]))
+                       + ((a & at(1)) | (at(2) & (a | at(1))));
+
+    at(3) += temp1;
+    at(7) = temp1 + temp2;
+}
+
+template<class Engine, size_t J>
+__attribute__((always_inline)) inline typename Engine::Word Schedule(std::array<typename Engine::Word, 16>& w, uint8_t const* block)
+{
+    // The message schedule as a ring of 16 words, w[J] overwriting w[J - 16]
+    using Word = typename Engine::Word;
+
+    auto constexpr& s0 = Engine::small_sigma0;
+    auto constexpr& s1 = Engine::small_sigma1;
+
+    if constexpr (J < 16) {
+        w[J] = LoadBigEndian<Word>(block + sizeof(Word) * J);
+    } else {
+        auto const w15 = w[(J - 15) & 15];
+        auto const w2 = w[(J - 2) & 15];
+
+        w[J & 15] += w[(J - 7) & 15]
+                     + (std::rotr(w15, s0[0]) ^ std::rotr(w15, s0[1]) ^ (w15 >> s0[2]))
+                     + (std::rotr(w2, s1[0]) ^ std::rotr(w2, s1[1]) ^ (w2 >> s1[2]));
+    }
+
+    return w[J & 15] + Engine::k[J];
+}
+
+template<class Engine, size_t... J>
+__attribute__((always_inline)) inline void Rounds(std::array<typename Engine::Word, 8>& state, uint8_t const* block, std::index_sequence<J...>)
+{
+    auto w = std::array<typename Engine::Word, 16> {};
+    auto s = state;
+
+    (Round<Engine, J>(s, Schedule<Engine, J>(w, block)), ...);
+
+    for (auto i = 0uz; i < 8; i++)
+        state[i] += s[i];
+}
+
+template<class Engine, size_t... J>
+__attribute__((always_inline)) inline void Rounds(std::array<typename Engine::Word, 8>& state, typename Engine::Word const* wk, std::index_sequence<J...>)
+{
+    auto s = state;
+
+    (Round<Engine, J>(s, wk[J]), ...);
+
+    for (auto i = 0uz; i < 8; i++)
+        state[i] += s[i];
+}
+
+template<class Engine>
+void CompressGeneric(std::array<typename Engine::Word, 8>& state, uint8_t const* blocks, size_t count)
+{
+    for (; count--; blocks += 16 * sizeof(typename Engine::Word))
+        Rounds<Engine>(state, blocks, std::make_index_sequence<Engine::rounds> {});
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template<int N>
+__attribute__((target("avx2"))) inline __m256i Rotr(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+}
+
+__attribute__((target("avx2"))) inline __m256i Sigma0(__m256i w)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(Rotr<7>(w), Rotr<18>(w)), _mm256_srli_epi32(w, 3));
+}
+
+__attribute__((target("avx2"))) inline __m256i Sigma1(__m256i w)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(Rotr<17>(w), Rotr<19>(w)), _mm256_srli_epi32(w, 10));
+}
+
+__attribute__((target("avx2"))) inline void StoreSchedule(__m256i words, size_t group, uint32_t* wk_first, uint32_t* wk_second)
+{
+    auto const wk = _mm256_add_epi32(words, _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&Engine32::k[4 * group]))));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wk_first + 4 * group), _mm256_castsi256_si128(wk));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(wk_second + 4 * group), _mm256_extracti128_si256(wk, 1));
+}
+
+__attribute__((target("avx2"))) void ScheduleAvx2(uint8_t const* first, uint8_t const* second, uint32_t* wk_first, uint32_t* wk_second)
+{
+    // W[t] + K[t] of two blocks at once, one in each 128-bit lane. Words are computed four at a time: the
+    // sigma1 terms of the upper two depend on the lower two, so they are added in a second step.
+    auto const swap = _mm256_broadcastsi128_si256(_mm_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203));
+    auto const lower = _mm256_set_epi32(0, 0, -1, -1, 0, 0, -1, -1);
+
+    __m256i x[4];
+
+    for (auto group = 0uz; group < 4; group++) {
+        auto const words = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first + 16 * group))),
+                                                   _mm_loadu_si128(reinterpret_cast<__m128i const*>(second + 16 * group)), 1);
+
+        x[group] = _mm256_shuffle_epi8(words, swap);
+        StoreSchedule(x[group], group, wk_first, wk_second);
+    }
+
+    for (auto group = 4uz; group < 16; group++) {
+        auto const w15 = _mm256_alignr_epi8(x[1], x[0], 4);
+        auto const w7 = _mm256_alignr_epi8(x[3], x[2], 4);
+        auto words = _mm256_add_epi32(_mm256_add_epi32(x[0], Sigma0(w15)), w7);
+
+        // W[t - 2], W[t - 1] in the lower words, then the new W[t], W[t + 1] in the upper words
+        words = _mm256_add_epi32(words, _mm256_and_si256(Sigma1(_mm256_shuffle_epi32(x[3], 0xfe)), lower));
+        words = _mm256_add_epi32(words, _mm256_andnot_si256(lower, Sigma1(_mm256_shuffle_epi32(words, 0x40))));
+
+        x[0] = x[1];
+        x[1] = x[2];
+        x[2] = x[3];
+        x[3] = words;
+        StoreSchedule(words, group, wk_first, wk_second);
+    }
+}
+
+__attribute__((target("avx2,bmi2"))) void CompressAvx2(std::array<uint32_t, 8>& state, uint8_t const* blocks, size_t count)
+{
+    // Blocks are scheduled in pairs, a last odd block is paired with itself. The rounds are inlined here to
+    // be compiled with BMI2, whose three-operand rotations save the register copies of the scalar version.
+    alignas(32) auto wk = std::array<std::array<uint32_t, 64>, 2> {};
+
+    for (; count; blocks += 2 * Sha256::block_size) {
+        auto const* second = count > 1 ? blocks + Sha256::block_size : blocks;
+
+        ScheduleAvx2(blocks, second, wk[0].data(), wk[1].data());
+        Rounds<Engine32>(state, wk[0].data(), std::make_index_sequence<64> {});
+
+        if (count == 1)
+            break;
+
+        Rounds<Engine32>(state, wk[1].data(), std::make_index_sequence<64> {});
+        count -= 2;
+    }
+}
+
+template<int J>
+__attribute__((target("sha,sse4.1"))) inline void ShaNiQuad(__m128i& abef, __m128i& cdgh, __m128i (&message)[4])
+{
+    // Rounds 4J to 4J + 3, then the message words of rounds 4J + 16 to 4J + 19 into the freed register
+    auto const wk = _mm_add_epi32(message[J & 3], _mm_loadu_si128(reinterpret_cast<__m128i const*>(&Engine32::k[4 * J])));
+
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+
+    if constexpr (J < 12) {
+        auto const w7 = _mm_alignr_epi8(message[(J + 3) & 3], message[(J + 2) & 3], 4);
+        auto const partial = _mm_add_epi32(_mm_sha256msg1_epu32(message[J & 3], message[(J + 1) & 3]), w7);
+
+        message[J & 3] = _mm_sha256msg2_epu32(partial, message[(J + 3) & 3]);
+    }
+}
+
+template<int... J>
+__attribute__((target("sha,sse4.1"))) inline void ShaNiBlock(__m128i& abef, __m128i& cdgh, uint8_t const* block, std::integer_sequence<int, J...>)
+{
+    auto const swap = _mm_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203);
+    __m128i message[4];
+
+    for (auto i = 0uz; i < 4; i++)
+        message[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16 * i)), swap);
+
+    (ShaNiQuad<J>(abef, cdgh, message), ...);
+}
+
+__attribute__((target("sha,sse4.1"))) void CompressShaNi(std::array<uint32_t, 8>& state, uint8_t const* blocks, size_t count)
+{
+    // sha256rnds2 keeps the working variables as ABEF and CDGH
+    auto const dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0])), 0xb1);
+    auto const efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4])), 0x1b);
+
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (; count--; blocks += Sha256::block_size) {
+        auto const saved_abef = abef;
+        auto const saved_cdgh = cdgh;
+
+        ShaNiBlock(abef, cdgh, blocks, std::make_integer_sequence<int, 16> {});
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto const feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto const dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+__attribute__((target("bmi2"))) void CompressBmi2(std::array<uint64_t, 8>& state, uint8_t const* blocks, size_t count)
+{
+    // The generic rounds, compiled with the three-operand rotations of BMI2
+    for (; count--; blocks += 16 * sizeof(uint64_t))
+        Rounds<Engine64>(state, blocks, std::make_index_sequence<Engine64::rounds> {});
+}
+#endif
+
+// Lanes of 32-bit words, in AVX2 and AVX-512 registers
+using Lanes8 = uint32_t __attribute__((vector_size(32)));
+using Lanes16 = uint32_t __attribute__((vector_size(64)));
+
+template<size_t Lanes>
+using LaneVector = std::conditional_t<Lanes == 16, Lanes16, Lanes8>;
+
+template<size_t J, class Vector>
+__attribute__((always_inline)) inline void LaneRound(Vector (&s)[8], Vector (&w)[16])
+{
+    // Round<J> and Schedule<J> on every lane at once, lane i holding the words of the i-th message. The
+    // rotations are spelled out, as helpers taking vectors by value would be outside the AVX calling convention.
+    auto constexpr at = [](size_t i) { return (i - J) & 7; };
+
+    if constexpr (J >= 16) {
+        auto const w15 = w[(J - 15) & 15];
+        auto const w2 = w[(J - 2) & 15];
+
+        w[J & 15] += w[(J - 7) & 15]
+                     + ((w15 >> 7 | w15 << 25) ^ (w15 >> 18 | w15 << 14) ^ (w15 >> 3))
+                     + ((w2 >> 17 | w2 << 15) ^ (w2 >> 19 | w2 << 13) ^ (w2 >> 10));
+    }
+
+    auto const a = s[at(0)];
+    auto const e = s[at(4)];
+    auto const temp1 = s[at(7)] + Engine32::k[J] + w[J & 15]
+                       + (s[at(6)] ^ (e & (s[at(5)] ^ s[at(6)])))
+                       + ((e >> 6 | e << 26) ^ (e >> 11 | e << 21) ^ (e >> 25 | e << 7));
+    auto const temp2 = ((a >> 2 | a << 30) ^ (a >> 13 | a << 19) ^ (a >> 22 | a << 10))
+                       + ((a & s[at(1)]) | (s[at(2)] & (a | s[at(1)])));
+
+    s[at(3)] += temp1;
+    s[at(7)] = temp1 + temp2;
+}
+
+template<class Vector, size_t... J>
+__attribute__((always_inline)) inline void LaneRounds(Vector (&s)[8], Vector (&w)[16], std::index_sequence<J...>)
+{
+    (LaneRound<J>(s, w), ...);
+}
+
+template<size_t B, class Vector, size_t... P>
+__attribute__((always_inline)) inline void TransposeStage(Vector* rows, std::index_sequence<P...>)
+{
+    // Exchanges the off-diagonal B x B blocks within every 2B x 2B block. The stages for B = 1, 2, 4, ...
+    // exchange the bits of the row and column indices one at a time, together a transpose.
+    auto constexpr N = sizeof...(P);
+
+    for (auto i = 0uz; i < N; i++) {
+        if (i & B)
+            continue;
+
+        auto const x = rows[i];
+        auto const y = rows[i + B];
+
+        rows[i] = __builtin_shufflevector(x, y, ((P & B) ? N + P - B : P)...);
+        rows[i + B] = __builtin_shufflevector(x, y, ((P & B) ? N + P : P + B)...);
+    }
+}
+
+template<class Vector, size_t... B>
+__attribute__((always_inline)) inline void Transpose(Vector* rows, std::index_sequence<B...>)
+{
+    auto constexpr lanes = sizeof(Vector) / sizeof(uint32_t);
+
+    (TransposeStage<size_t { 1 } << B>(rows, std::make_index_sequence<lanes> {}), ...);
+}
+
+template<size_t Lanes>
+__attribute__((always_inline)) inline void CompressLanes(LaneVector<Lanes> (&state)[8], std::array<uint8_t const*, Lanes> const& blocks)
+{
+    // One block of every lane. Each block is loaded into vectors and Lanes words at a time are transposed, so
+    // that w[t] holds word t of every block.
+    using Vector = LaneVector<Lanes>;
+
+    Vector w[16];
+    Vector s[8];
+
+    for (auto part = 0uz; part < 16 / Lanes; part++) {
+        auto* rows = w + part * Lanes;
+
+        for (auto lane = 0uz; lane < Lanes; lane++)
+            std::memcpy(&rows[lane], blocks[lane] + part * sizeof(Vector), sizeof(Vector));
+
+        Transpose(rows, std::make_index_sequence<std::countr_zero(Lanes)> {});
+    }
+
+    // Big-endian words: rotating by 8 both ways leaves bytes 0 and 2, and bytes 1 and 3, in place
+    for (auto& word : w)
+        word = ((word << 8 | word >> 24) & 0x00ff00ff) | ((word >> 8 | word << 24) & 0xff00ff00);
+
+    std::copy(state, state + 8, s);
+
+    LaneRounds(s, w, std::make_index_sequence<64> {});
+
+    for (auto i = 0uz; i < 8; i++)
+        state[i] += s[i];
+}
+
+template<class Parameters, size_t Lanes>
+__attribute__((always_inline)) inline void HashLanes(std::span<std::span<std::byte const> const> messages, std::span<size_t const> group, std::span<typename Sha2<Parameters>::Digest> digests)
+{
+    // The messages of group, at most Lanes of them, stepped one block at a time. A lane that has run out of
+    // blocks keeps hashing its padding, and its digest is taken after its own last block.
+    using Vector = LaneVector<Lanes>;
+
+    auto constexpr block_size = Sha2<Parameters>::block_size;
+
+    struct Lane {
+        uint8_t const* m_data = nullptr;
+        size_t m_full = 0;   // Blocks read in place from the message
+        size_t m_blocks = 0; // Including the one or two padding blocks
+        std::array<uint8_t, 2 * block_size> m_tail {};
+    };
+
+    // A plain array: GCC folds the identical std::array<Lane, 8> and <Lane, 16> accessors into one and then
+    // warns about the 16-element one indexing the 8-element array
+    Lane lanes[Lanes] {};
+    auto most = 0uz;
+
+    for (auto i = 0uz; i < group.size(); i++) {
+        auto const message = messages[group[i]];
+        auto& lane = lanes[i];
+
+        lane.m_data = reinterpret_cast<uint8_t const*>(message.data());
+        lane.m_full = message.size() / block_size;
+        lane.m_blocks = lane.m_full + Pad<block_size>(lane.m_tail, lane.m_data + lane.m_full * block_size, message.size() % block_size, message.size());
+        most = std::max(most, lane.m_blocks);
+    }
+
+    Vector state[8];
+
+    for (auto i = 0uz; i < 8; i++)
+        state[i] = Vector {} + Parameters::initial[i];
+
+    for (auto block = 0uz; block < most; block++) {
+        auto pointers = std::array<uint8_t const*, Lanes> {};
+
+        for (auto i = 0uz; i < Lanes; i++) {
+            auto const& lane = lanes[i];
+
+            if (block < lane.m_full)
+                pointers[i] = lane.m_data + block * block_size;
+            else
+                pointers[i] = lane.m_tail.data() + std::min(block - lane.m_full, 1uz) * block_size;
+        }
+
+        CompressLanes<Lanes>(state, pointers);
+
+        if (std::ranges::none_of(lanes, [&](Lane const& lane) { return lane.m_blocks == block + 1; }))
+            continue;
+
+        alignas(64) uint32_t words[8][Lanes];
+        std::memcpy(words, state, sizeof(words));
+
+        for (auto i = 0uz; i < group.size(); i++) {
+            if (lanes[i].m_blocks != block + 1)
+                continue;
+
+            auto column = std::array<uint32_t, 8> {};
+
+            for (auto j = 0uz; j < 8; j++)
+                column[j] = words[j][i];
+
+            digests[group[i]] = ToDigest<Parameters>(column);
+        }
+    }
+}
+
+template<size_t Lanes>
+__attribute__((always_inline)) inline void CompressStates(std::span<std::array<uint32_t, 8>> states, std::span<std::byte const* const> blocks)
+{
+    // One block for each of Lanes states, transposed into the lanes and back
+    using Vector = LaneVector<Lanes>;
+
+    alignas(64) uint32_t words[8][Lanes];
+    Vector state[8];
+    auto pointers = std::array<uint8_t const*, Lanes> {};
+
+    for (auto i = 0uz; i < Lanes; i++) {
+        for (auto j = 0uz; j < 8; j++)
+            words[j][i] = states[i][j];
+
+        pointers[i] = reinterpret_cast<uint8_t const*>(blocks[i]);
+    }
+
+    std::memcpy(state, words, sizeof(words));
+    CompressLanes<Lanes>(state, pointers);
+    std::memcpy(words, state, sizeof(words));
+
+    for (auto i = 0uz; i < Lanes; i++)
+        for (auto j = 0uz; j < 8; j++)
+            states[i][j] = words[j][i];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2"))) void CompressStatesAvx2(std::span<std::array<uint32_t, 8>> states, std::span<std::byte const* const> blocks)
+{
+    CompressStates<8>(states, blocks);
+}
+
+__attribute__((target("avx512f"))) void CompressStatesAvx512(std::span<std::array<uint32_t, 8>> states, std::span<std::byte const* const> blocks)
+{
+    CompressStates<16>(states, blocks);
+}
+
+template<class Parameters>
+__attribute__((target("avx2"))) void HashLanesAvx2(std::span<std::span<std::byte const> const> messages, std::span<size_t const> group, std::span<typename Sha2<Parameters>::Digest> digests)
+{
+    HashLanes<Parameters, 8>(messages, group, digests);
+}
+
+template<class Parameters>
+__attribute__((target("avx512f"))) void HashLanesAvx512(std::span<std::span<std::byte const> const> messages, std::span<size_t const> group, std::span<typename Sha2<Parameters>::Digest> digests)
+{
+    HashLanes<Parameters, 16>(messages, group, digests);
+}
+#endif
+
+template<class Word>
+using CompressFunction = void (*)(std::array<Word, 8>&, uint8_t const*, size_t);
+
+CompressFunction<uint32_t> Select(std::array<uint32_t, 8> const&, SHA2::Implementation implementation)
+{
+    switch (implementation) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SHA2::Implementation::ShaNi:
+        return CompressShaNi;
+    case SHA2::Implementation::Avx2:
+        return CompressAvx2;
+#endif
+    default:
+        return CompressGeneric<Engine32>;
+    }
+}
+
+CompressFunction<uint64_t> Select(std::array<uint64_t, 8> const&, SHA2::Implementation implementation)
+{
+    switch (implementation) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SHA2::Implementation::Bmi2:
+        return CompressBmi2;
+#endif
+    default:
+        return CompressGeneric<Engine64>;
+    }
+}
+
+template<class Parameters>
+void Compress(std::array<typename Parameters::Word, 8>& state, uint8_t const* blocks, size_t count)
+{
+    static auto const compress = Select(state, Sha2<Parameters>::get_implementation());
+
+    compress(state, blocks, count);
+}
+}
+
+template<class Parameters>
+SHA2::Implementation Sha2<Parameters>::get_implementation()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    if constexpr (sizeof(Word) == 4) {
+        if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"))
+            return Implementation::ShaNi;
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+            return Implementation::Avx2;
+    } else {
+        if (__builtin_cpu_supports("bmi2"))
+            return Implementation::Bmi2;
+    }
+#endif
+
+    return Implementation::Generic;
+}
+
+template<class Parameters>
+Sha2<Parameters>::Sha2()
+    : m_state(Parameters::initial)
+{
+}
+
+template<class Parameters>
+Sha2<Parameters>& Sha2<Parameters>::update(std::span<std::byte const> data)
+{
+    auto const* bytes = reinterpret_cast<uint8_t const*>(data.data());
+    auto size = data.size();
+
+    m_length += size;
+
+    // Complete a partial block first, then hash whole blocks in place and keep the rest
+    if (m_buffered) {
+        auto const take = std::min(size, block_size - m_buffered);
+
+        std::memcpy(m_buffer.data() + m_buffered, bytes, take);
+        m_buffered += take;
+        bytes += take;
+        size -= take;
+
+        if (m_buffered < block_size)
+            return *this;
+
+        Compress<Parameters>(m_state, m_buffer.data(), 1);
+        m_buffered = 0;
+    }
+
+    if (auto const blocks = size / block_size) {
+        Compress<Parameters>(m_state, bytes, blocks);
+        bytes += blocks * block_size;
+        size -= blocks * block_size;
+    }
+
+    if (size) {
+        std::memcpy(m_buffer.data(), bytes, size);
+        m_buffered = size;
+    }
+
+    return *this;
+}
+
+template<class Parameters>
+Sha2<Parameters>& Sha2<Parameters>::update(std::span<uint8_t const> data) { return update(std::as_bytes(data)); }
+
+template<class Parameters>
+typename Sha2<Parameters>::Digest Sha2<Parameters>::final()
+{
+    auto tail = std::array<uint8_t, 2 * block_size> {};
+    auto const blocks = Pad<block_size>(tail, m_buffer.data(), m_buffered, m_length);
+
+    Compress<Parameters>(m_state, tail.data(), blocks);
+
+    auto const digest = ToDigest<Parameters>(m_state);
+
+    *this = Sha2 {};
+
+    return digest;
+}
+
+template<class Parameters>
+typename Sha2<Parameters>::Digest Sha2<Parameters>::hash(std::span<std::byte const> data) { return Sha2 {}.update(data).final(); }
+
+template<class Parameters>
+typename Sha2<Parameters>::Digest Sha2<Parameters>::hash(std::span<uint8_t const> data) { return hash(std::as_bytes(data)); }
+
+template<class Parameters>
+std::vector<typename Sha2<Parameters>::Digest> Sha2<Parameters>::hash(std::span<std::span<std::byte const> const> messages)
+{
+    auto digests = std::vector<Digest>(messages.size());
+    auto const lanes = get_lanes();
+
+    // Sorted by number of blocks, so that the messages sharing the lanes finish together. Sizes are usually
+    // uniform or already ordered, and then the sort is skipped.
+    auto keyed = std::vector<std::pair<size_t, size_t>>(messages.size());
+
+    for (auto i = 0uz; i < messages.size(); i++)
+        keyed[i] = { messages[i].size() / block_size, i };
+
+    if (!std::ranges::is_sorted(keyed))
+        std::ranges::sort(keyed);
+
+    auto order = std::vector<size_t>(messages.size());
+    std::ranges::transform(keyed, order.begin(), [](auto const& entry) { return entry.second; });
+
+    auto next = 0uz;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if constexpr (sizeof(Word) == 4) {
+        for (; lanes > 1 && next + lanes <= order.size(); next += lanes) {
+            auto const group = std::span<size_t const>(order).subspan(next, lanes);
+
+            if (lanes == 16)
+                HashLanesAvx512<Parameters>(messages, group, digests);
+            else
+                HashLanesAvx2<Parameters>(messages, group, digests);
+        }
+    }
+#endif
+
+    // Too few left to fill the lanes
+    for (; next < order.size(); next++)
+        digests[order[next]] = hash(messages[order[next]]);
+
+    return digests;
+}
+
+template<class Parameters>
+void Sha2<Parameters>::compress(State& state, std::span<std::byte const> blocks)
+{
+    Compress<Parameters>(state, reinterpret_cast<uint8_t const*>(blocks.data()), blocks.size() / block_size);
+}
+
+template<class Parameters>
+void Sha2<Parameters>::compress(std::span<State> states, std::span<std::byte const* const> blocks)
+{
+    auto const lanes = get_lanes();
+    auto next = 0uz;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if constexpr (sizeof(Word) == 4) {
+        for (; lanes > 1 && next + lanes <= states.size(); next += lanes) {
+            if (lanes == 16)
+                CompressStatesAvx512(states.subspan(next, lanes), blocks.subspan(next, lanes));
+            else
+                CompressStatesAvx2(states.subspan(next, lanes), blocks.subspan(next, lanes));
+        }
+    }
+#endif
+
+    for (; next < states.size(); next++)
+        Compress<Parameters>(states[next], reinterpret_cast<uint8_t const*>(blocks[next]), 1);
+}
+
+template<class Parameters>
+typename Sha2<Parameters>::Digest Sha2<Parameters>::to_digest(State const& state) { return ToDigest<Parameters>(state); }
+
+template<class Parameters>
+size_t Sha2<Parameters>::get_lanes()
+{
+    // Lanes of 32-bit words only. Eight lanes do not keep up with the SHA extensions working on one message.
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    if constexpr (sizeof(Word) == 4) {
+        if (__builtin_cpu_supports("avx512f"))
+            return 16;
+
+        if (__builtin_cpu_supports("avx2") && get_implementation() != Implementation::ShaNi)
+            return 8;
+    }
+#endif
+
+    return 1;
+}
+
+template class Sha2<SHA2::Sha224Parameters>;
+template class Sha2<SHA2::Sha256Parameters>;
+template class Sha2<SHA2::Sha384Parameters>;
+template class Sha2<SHA2::Sha512Parameters>;
+template class Sha2<SHA2::Sha512_256Parameters>;
@@ -1,20 +1,32 @@
 #pragma once
-#include "Modmath.h"
+
 #include <array>
-#include <cassert>
+#include <cstddef>
 #include <cstdint>
-#include <iostream>
+#include <span>
 #include <vector>
 
-namespace SHA256 {
-inline uint32_t ROTR(uint32_t x, int k)
-{
-    return (x >> k) | (x << (32 - k));
-}
-
-std::array<uint32_t, 8> Hash(std::vector<bool> message)
-{
-    uint32_t static const constexpr k[64] = {
+namespace SHA2 {
+enum class Implementation {
+    Generic,
+    Bmi2,
+    Avx2,
+    ShaNi,
+};
+
+// The two compression engines of FIPS 180-4: word width, round count, round constants, and the rotations of
+// Sigma0 and Sigma1 and the rotations and shift of sigma0 and sigma1 (4.1.2, 4.1.3)
+struct Engine32 {
+    using Engine = Engine32;
+    using Word = uint32_t;
+
+    static constexpr size_t rounds = 64;
+    static constexpr std::array<int, 3> big_sigma0 { 2, 13, 22 };
+    static constexpr std::array<int, 3> big_sigma1 { 6, 11, 25 };
+    static constexpr std::array<int, 3> small_sigma0 { 7, 18, 3 };
+    static constexpr std::array<int, 3> small_sigma1 { 17, 19, 10 };
+
+    static constexpr std::array<uint32_t, 64> k {
         0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
         0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
         0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -24,66 +36,139 @@ std::array<uint32_t, 8> Hash(std::vector<bool> message)
         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
         0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
     };
+};
+
+struct Engine64 {
+    using Engine = Engine64;
+    using Word = uint64_t;
+
+    static constexpr size_t rounds = 80;
+    static constexpr std::array<int, 3> big_sigma0 { 28, 34, 39 };
+    static constexpr std::array<int, 3> big_sigma1 { 14, 18, 41 };
+    static constexpr std::array<int, 3> small_sigma0 { 1, 8, 7 };
+    static constexpr std::array<int, 3> small_sigma1 { 19, 61, 6 };
+
+    static constexpr std::array<uint64_t, 80> k {
+        0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc, 0x3956c25bf348b538,
+        0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242, 0x12835b0145706fbe,
+        0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2, 0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+        0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+        0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5, 0x983e5152ee66dfab,
+        0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+        0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed,
+        0x53380d139d95b3df, 0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+        0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+        0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8, 0x19a4c116b8d2d0c8, 0x1e376c085141ab53,
+        0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373,
+        0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+        0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b, 0xca273eceea26619c,
+        0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba, 0x0a637dc5a2c898a6,
+        0x113f9804bef90dae, 0x1b710b35131c471b, 0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+        0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+    };
+};
 
-    auto static h = std::array<uint32_t, 8> { 0x6a09e667,
-                                              0xbb67ae85,
-                                              0x3c6ef372,
-                                              0xa54ff53a,
-                                              0x510e527f,
-                                              0x9b05688c,
-                                              0x1f83d9ab,
-                                              0x5be0cd19 };
-
-    auto static a = h;
-
-    auto const L = message.size();
-    auto const K = Modsub(512, L + 65, 512);
-    auto padding = std::vector<bool>(K + 65);
-
-    for (auto i = 0; i < 64; i++)
-        padding[K + 1 + i] = (L >> (63 - i)) & 1;
-
-    message.reserve(L + K + 65);
-    message.insert(message.end(), padding.begin(), padding.end());
-
-    message[L] = true;
-
-    assert(message.size() % 512 == 0);
-
-    for (auto i = 0; i < (message.size() >> 9); i++) {
-        uint32_t w[64] = { 0 };
-
-        // Copy first 512 bits of message into w[0..16]
-        for (auto j = 0; j < 16; j++)
-            for (auto k = 0; k < 32; k++)
-                w[j] |= message[j * 32 + k] << (31 - k);
-
-        for (auto j = 16; j < 64; j++)
-            w[j] = w[j - 16] + w[j - 7]
-                   + (ROTR(w[j - 15], 7) ^ ROTR(w[j - 15], 18) ^ (w[j - 15] >> 3))
-                   + (ROTR(w[j - 2], 17) ^ ROTR(w[j - 2], 19) ^ (w[j - 2] >> 10));
-
-        for (auto j = 0; j < 64; j++) {
-            auto temp1 = a[7] + k[j] + w[j]
-                         + (a[6] ^ (a[4] & (a[5] ^ a[6])))
-                         + (ROTR(a[4], 6) ^ ROTR(a[4], 11) ^ ROTR(a[4], 25));
-            auto temp2 = ((ROTR(a[0], 2) ^ ROTR(a[0], 13) ^ ROTR(a[0], 22)))
-                         + ((a[0] & a[1]) | (a[2] & (a[0] | a[1])));
+// Initial hash values and digest sizes of the variants (5.3), the digest being the leading bytes of the state
+struct Sha224Parameters : Engine32 {
+    static constexpr size_t digest_size = 28;
+    static constexpr std::array<uint32_t, 8> initial {
+        0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+    };
+};
 
-            for (auto i = 7; i-- > 0;)
-                a[i + 1] = a[i];
+struct Sha256Parameters : Engine32 {
+    static constexpr size_t digest_size = 32;
+    static constexpr std::array<uint32_t, 8> initial {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+};
 
-            a[4] += temp1;
-            a[0] = temp1 + temp2;
-        }
+struct Sha384Parameters : Engine64 {
+    static constexpr size_t digest_size = 48;
+    static constexpr std::array<uint64_t, 8> initial {
+        0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+        0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4
+    };
+};
 
-        [&]<std::size_t... I>(std::index_sequence<I...>)
-        {
-            ((h[I] += a[I]), ...);
-        }
-        (std::make_index_sequence<8> {});
-    }
+struct Sha512Parameters : Engine64 {
+    static constexpr size_t digest_size = 64;
+    static constexpr std::array<uint64_t, 8> initial {
+        0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+    };
+};
 
-    return h;
-}
+struct Sha512_256Parameters : Engine64 {
+    static constexpr size_t digest_size = 32;
+    static constexpr std::array<uint64_t, 8> initial {
+        0x22312194fc2bf72c, 0x9f555fa3c84c64c2, 0x2393b86b6f53b151, 0x963877195940eabd,
+        0x96283ee2a88effe3, 0xbe5e1e2553863992, 0x2b0199fc2c85b8aa, 0x0eb72ddc81c52ca2
+    };
+};
 }
+
+template<class Parameters>
+class Sha2 {
+    /**
+     * SHA-2 (FIPS 180-4) over a stream of bytes, one implementation for every variant
+     * Input is consumed in blocks of 16 words straight from the caller's memory; only the tail of an update that
+     * does not fill a block is copied, so any amount of data is hashed in constant memory. The state belongs
+     * to the instance: separate instances can be used from separate threads.
+     * The compression function is picked once at runtime from the CPU features. For 32-bit words: the SHA
+     * extensions, or scalar BMI2 rounds over a message schedule computed with AVX2 for two blocks at a time.
+     * For 64-bit words: scalar rounds with BMI2. Plain C++ otherwise.
+     */
+public:
+    using Word = typename Parameters::Word;
+    using Digest = std::array<uint8_t, Parameters::digest_size>;
+    using Implementation = SHA2::Implementation;
+    using State = std::array<Word, 8>;
+
+    static constexpr size_t block_size = 16 * sizeof(Word);
+    static constexpr State initial_state = Parameters::initial;
+
+private:
+    State m_state;
+    std::array<uint8_t, block_size> m_buffer {};
+    size_t m_buffered { 0 };
+    uint64_t m_length { 0 }; // Bytes consumed so far
+
+public:
+    Sha2();
+
+    Sha2& update(std::span<std::byte const> data);
+    Sha2& update(std::span<uint8_t const> data);
+
+    // Pads the message and returns its digest, the context starts over afterwards
+    Digest final();
+
+    static Digest hash(std::span<std::byte const> data);
+    static Digest hash(std::span<uint8_t const> data);
+
+    // Digests of many independent messages, hashed get_lanes() at a time across the lanes of AVX-512 or AVX2
+    // vectors. Messages are grouped by length so that the messages sharing the lanes finish together.
+    static std::vector<Digest> hash(std::span<std::span<std::byte const> const> messages);
+
+    // The compression function on its own, for constructions that resume from a saved chaining value such as
+    // the keyed states of HMAC. Blocks are whole and already padded.
+    static void compress(State& state, std::span<std::byte const> blocks);
+
+    // One block for each of many independent states, across the lanes of the multi-message hash
+    static void compress(std::span<State> states, std::span<std::byte const* const> blocks);
+
+    // The leading digest_size bytes of the big-endian state
+    static Digest to_digest(State const& state);
+
+    // The fastest compression function this CPU supports for the word size
+    static Implementation get_implementation();
+
+    // Messages hashed together by the multi-message hash, 1 when hashing them one by one is faster
+    static size_t get_lanes();
+};
+
+using Sha224 = Sha2<SHA2::Sha224Parameters>;
+using Sha256 = Sha2<SHA2::Sha256Parameters>;
+using Sha384 = Sha2<SHA2::Sha384Parameters>;
+using Sha512 = Sha2<SHA2::Sha512Parameters>;
+using Sha512_256 = Sha2<SHA2::Sha512_256Parameters>;
@@ -1,7 +1,8 @@
 #include <BigInt/BigInt.h>
-#include <EllipticCurve/EllipticCurve.h>
+#include <Factorization/Factorization.h>
 #include <Modmath.h>
 
+#include <cmath>
 #include <iostream>
 #include <random>
 
@@ -103,6 +104,24 @@ BigInt Modinv(BigInt const& n, BigInt const& mod)
     return coeff;
 }
 
+uint64_t Modinv64(uint64_t n, uint64_t mod)
+{
+    // Extended Euclid on words, the coefficients stay below mod in absolute value
+    auto r0 = static_cast<int64_t>(mod);
+    auto r1 = static_cast<int64_t>(n % mod);
+    auto s0 = int64_t { 0 };
+    auto s1 = int64_t { 1 };
+
+    while (r1) {
+        auto const q = r0 / r1;
+
+        r0 = std::exchange(r1, r0 - q * r1);
+        s0 = std::exchange(s1, s0 - q * s1);
+    }
+
+    return static_cast<uint64_t>(s0 < 0 ? s0 + static_cast<int64_t>(mod) : s0);
+}
+
 BigInt Modexp(BigInt const& base, BigInt exp, BigInt const& mod)
 {
     // Implementation of fast powering approach to exponentiation in integer rings
@@ -116,10 +135,6 @@ BigInt Modexp(BigInt const& base, BigInt exp, BigInt const& mod)
     if (exp == 2)
         return (base * base) % mod;
 
-    // Given a^n (mod m); If n > m, then exp := exp (mod Totient(m))
-    if (exp > mod)
-        exp %= Totient(mod);
-
     auto accumulator = BigInt { 1 };
 
 #ifdef MONTGOMERY
@@ -148,136 +163,579 @@ BigInt Modexp(BigInt const& base, BigInt exp, BigInt const& mod)
     return accumulator % mod;
 }
 
-bool MillerRabin(BigInt const& n)
+BigInt Isqrt(BigInt const& n)
+{
+    // Floor of the square root of n >= 0 by Newton's method, starting above the root
+    if (n <= 1)
+        return n;
+
+    auto x = BigInt { 1 } << static_cast<int>((n.size() + 1) / 2);
+
+    while (true) {
+        auto y = (x + n / x) >> 1;
+
+        if (y >= x)
+            return x;
+
+        x = y;
+    }
+}
+
+int Jacobi(BigInt const& a, BigInt const& n)
 {
     /**
-     * Miller-Rabin primality test
-     * Returns true if composite; false if probably prime
-     *
-     * Miller-Rabin is a non-deterministic primality test.
-     * It has been shown by Sorenson and Webster (doi:10.1090/mcom/3134) that for
-     * a composite number n < 3,317,044,064,679,887,385,961,981 (< 82 bits) at
-     * least one of the bases below will be a witness to the compositeness of n.
+     * Jacobi symbol (a/n) for odd n > 0, binary algorithm with shifts and subtractions only
+     * Factors of two flip the sign when n = 3, 5 mod 8, and swapping a and n by quadratic reciprocity flips it
+     * when both are 3 mod 4. Subtracting n from a leaves the symbol unchanged.
      */
+    auto x = a % n;
+    auto m = n;
+    auto result = 1;
+
+    while (!x.is_zero()) {
+        auto const t = x.trailing_zeros();
+        x >>= static_cast<int>(t);
+
+        // n mod 8 is 3 or 5 exactly when its bits 1 and 2 differ
+        if ((t & 1) && (m.bit_at(1) != m.bit_at(2)))
+            result = -result;
+
+        if (x < m) {
+            if (x.bit_at(1) && m.bit_at(1))
+                result = -result;
+
+            std::swap(x, m);
+        }
+
+        x -= m;
+    }
+
+    return m == 1 ? result : 0;
+}
+
+int Jacobi64(uint64_t a, uint64_t n)
+{
+    // Jacobi symbol (a/n) for odd n, binary algorithm without exponentiation
+    auto result = 1;
+    a %= n;
+
+    while (a) {
+        auto const t = __builtin_ctzll(a);
+        a >>= t;
+
+        if ((t & 1) && (n % 8 == 3 || n % 8 == 5))
+            result = -result;
+
+        if (a % 4 == 3 && n % 4 == 3)
+            result = -result;
+
+        std::swap(a, n);
+        a %= n;
+    }
+
+    return n == 1 ? result : 0;
+}
+
+int Legendre(BigInt const& a, BigInt const& p)
+{
+    // For an odd prime p the Jacobi symbol is the Legendre symbol
+    return Jacobi(a, p);
+}
+
+namespace {
+std::optional<BigInt> TonelliShanks(BigInt const& n, BigInt const& p)
+{
+    /**
+     * Tonelli-Shanks, for a residue n mod an odd prime p
+     * Write p - 1 = 2^s q with q odd and take z a non-residue. Start from x = n^((q + 1) / 2), which is off
+     * by the unit t = n^q of order 2^m, and fix it with powers of z of matching order until t = 1.
+     */
+    auto const s = (p - 1).trailing_zeros();
+    auto const q = (p - 1) >> static_cast<int>(s);
+
+    auto z = BigInt { 2 };
+
+    while (Jacobi(z, p) != -1)
+        z += 1;
+
+    auto m = s;
+    auto c = Modexp(z, q, p);
+    auto t = Modexp(n, q, p);
+    auto x = Modexp(n, (q + 1) >> 1, p);
+
+    while (t != 1) {
+        // Least i with t^(2^i) = 1
+        auto i = 0uz;
+
+        for (auto u = t; u != 1; u = (u * u) % p)
+            i++;
+
+        auto b = c;
+
+        for (auto j = i + 1; j < m; j++)
+            b = (b * b) % p;
+
+        m = i;
+        c = (b * b) % p;
+        t = (t * c) % p;
+        x = (x * b) % p;
+    }
+
+    return x;
+}
+
+std::optional<BigInt> Cipolla(BigInt const& n, BigInt const& p)
+{
+    /**
+     * Cipolla, for a residue n mod an odd prime p
+     * Find t with w = t^2 - n a non-residue, then (t + sqrt(w))^((p + 1) / 2) in F_p(sqrt(w)) is a root of n.
+     * Its cost does not grow with the power of two in p - 1, unlike Tonelli-Shanks.
+     */
+    auto t = BigInt { 1 };
+    auto w = (t * t - n) % p;
+
+    while (Jacobi(w, p) != -1) {
+        t += 1;
+        w = (t * t - n) % p;
+    }
+
+    // (x0 + x1 sqrt(w)) (y0 + y1 sqrt(w))
+    auto const mul = [&](std::pair<BigInt, BigInt> const& x, std::pair<BigInt, BigInt> const& y) {
+        return std::pair {
+            (x.first * y.first + (x.second * y.second % p) * w) % p,
+            (x.first * y.second + x.second * y.first) % p,
+        };
+    };
+
+    auto const e = (p + 1) >> 1;
+    auto result = std::pair<BigInt, BigInt> { 1, 0 };
+
+    for (auto i = e.size(); i-- > 0;) {
+        result = mul(result, result);
+
+        if (e.bit_at(i))
+            result = mul(result, { t, 1 });
+    }
+
+    return result.first;
+}
+}
+
+std::optional<BigInt> Modsqrt(BigInt const& a, BigInt const& p)
+{
+    // Square root mod an odd prime p, picking the method by the residue class of p
+    auto const n = a % p;
+
+    if (n.is_zero())
+        return n;
+
+    if (Jacobi(n, p) != 1)
+        return std::nullopt;
+
+    // p = 3 mod 4: n^((p + 1) / 4)
+    if (p.bit_at(1))
+        return Modexp(n, (p + 1) >> 2, p);
+
+    // p = 5 mod 8 (Atkin): b = (2n)^((p - 5) / 8), i = 2nb^2 is a square root of -1, and nb(i - 1) a root of n
+    if (p.bit_at(2)) {
+        auto const b = Modexp(n * 2, (p - 5) >> 3, p);
+        auto const i = n * 2 % p * b % p * b % p;
+
+        return n * b % p * (i - 1) % p;
+    }
+
+    // Tonelli-Shanks pays about s^2 / 4 products for p - 1 = 2^s q, Cipolla a constant 6 log p
+    auto const s = (p - 1).trailing_zeros();
+
+    if (s * s > 24 * p.size())
+        return Cipolla(n, p);
+
+    return TonelliShanks(n, p);
+}
+
+namespace {
+__extension__ using uint128_t = unsigned __int128;
+
+inline uint64_t Mulmod64(uint64_t a, uint64_t b, uint64_t mod)
+{
+    return static_cast<uint64_t>(static_cast<uint128_t>(a) * b % mod);
+}
+
+uint64_t Modexp64(uint64_t base, uint64_t exp, uint64_t mod)
+{
+    auto result = uint64_t { 1 };
+    base %= mod;
+
+    for (; exp; exp >>= 1) {
+        if (exp & 1)
+            result = Mulmod64(result, base, mod);
+
+        base = Mulmod64(base, base, mod);
+    }
+
+    return result;
+}
+
+bool StrongProbablePrime64(uint64_t n, uint64_t base)
+{
+    // Strong probable prime test of odd n > 2 to the given base
+    auto const np = n - 1;
+    auto const r = __builtin_ctzll(np);
+    auto const d = np >> r;
+
+    base %= n;
+
+    if (base == 0)
+        return true;
+
+    auto x = Modexp64(base, d, n);
+
+    if (x == 1 || x == np)
+        return true;
+
+    for (auto i = 1; i < r; i++) {
+        x = Mulmod64(x, x, n);
+
+        if (x == np)
+            return true;
+    }
+
+    return false;
+}
+
+bool StrongLucas64(uint64_t n)
+{
+    // Strong Lucas probable prime test with Selfridge's parameters P = 1, Q = (1 - D) / 4, n odd and not a square.
+    // D is the first of 5, -7, 9, -11, ... with (D/n) = -1; since D = 1 (mod 4), (D/n) = (n/|D|).
+    auto D = int64_t { 5 };
+
+    while (Jacobi64(n % static_cast<uint64_t>(D < 0 ? -D : D), static_cast<uint64_t>(D < 0 ? -D : D)) != -1)
+        D = D > 0 ? -(D + 2) : -D + 2;
+
+    auto const mod = [n](int64_t value) {
+        auto const r = value % static_cast<int64_t>(n);
+        return static_cast<uint64_t>(r < 0 ? r + static_cast<int64_t>(n) : r);
+    };
+
+    auto const half = [n](uint64_t value) {
+        return (value & 1) ? static_cast<uint64_t>((static_cast<uint128_t>(value) + n) >> 1) : value >> 1;
+    };
+
+    auto const add = [n](uint64_t a, uint64_t b) { return static_cast<uint64_t>((static_cast<uint128_t>(a) + b) % n); };
+    auto const sub = [n](uint64_t a, uint64_t b) { return a >= b ? a - b : a + (n - b); };
+
+    auto const Q = mod((1 - D) / 4);
+    auto const Dm = mod(D);
+
+    auto const s = __builtin_ctzll(n + 1);
+    auto const d = (n + 1) >> s;
+
+    auto U = uint64_t { 1 };
+    auto V = uint64_t { 1 };
+    auto Qk = Q;
+
+    for (auto i = 63 - __builtin_clzll(d); i-- > 0;) {
+        U = Mulmod64(U, V, n);
+        V = sub(Mulmod64(V, V, n), Mulmod64(2, Qk, n));
+        Qk = Mulmod64(Qk, Qk, n);
+
+        if ((d >> i) & 1) {
+            auto const u = half(add(U, V));
+            V = half(add(Mulmod64(Dm, U, n), V));
+            U = u;
+            Qk = Mulmod64(Qk, Q, n);
+        }
+    }
 
-    if (n.get_groups().front() % 2 == 0)
+    if (U == 0 || V == 0)
         return true;
 
-    auto np = n - 1;
-    auto r = np.trailing_zeros();
-    auto d = np >> r;
-
-    // clang-format off
-    auto static constexpr bases = std::integer_sequence<uint64_t, 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43> {};
-    auto static constexpr large_bases = std::integer_sequence<uint64_t, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97, 101,
-    103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223, 227,
-    229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311, 313, 317, 331, 337, 347, 349, 353, 359,
-    367, 373, 379, 383, 389, 397, 401, 409, 419, 421, 431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491, 499,
-    503, 509, 521, 523, 541, 547, 557, 563, 569, 571, 577, 587, 593, 599, 601, 607, 613, 617, 619, 631, 641, 643, 647,
-    653, 659, 661, 673, 677, 683, 691, 701, 709, 719, 727, 733, 739, 743, 751, 757, 761, 769, 773, 787, 797, 809, 811,
-    821, 823, 827, 829, 839, 853, 857, 859, 863, 877, 881, 883, 887, 907, 911, 919, 929, 937, 941, 947, 953, 967, 971,
-    977, 983, 991, 997, 1009, 1013, 1019, 1021, 1031, 1033, 1039, 1049, 1051, 1061, 1063, 1069, 1087, 1091, 1093, 1097,
-    1103, 1109, 1117, 1123, 1129, 1151, 1153, 1163, 1171, 1181, 1187, 1193, 1201, 1213, 1217, 1223, 1229, 1231, 1237,
-    1249, 1259, 1277, 1279, 1283, 1289, 1291, 1297, 1301, 1303, 1307, 1319, 1321, 1327, 1361, 1367, 1373, 1381, 1399,
-    1409, 1423, 1427, 1429, 1433, 1439, 1447, 1451, 1453, 1459, 1471, 1481, 1483, 1487, 1489, 1493, 1499, 1511, 1523,
-    1531, 1543, 1549, 1553, 1559, 1567, 1571, 1579, 1583, 1597, 1601, 1607, 1609, 1613, 1619, 1621, 1627, 1637, 1657,
-    1663, 1667, 1669, 1693, 1697, 1699, 1709, 1721, 1723, 1733, 1741, 1747, 1753, 1759, 1777, 1783, 1787, 1789, 1801,
-    1811, 1823, 1831, 1847, 1861, 1867, 1871, 1873, 1877, 1879, 1889, 1901, 1907, 1913, 1931, 1933, 1949, 1951, 1973,
-    1979, 1987, 1993, 1997, 1999, 2003, 2011, 2017, 2027, 2029> {};
-    // clang-format on
-
-    bool composite = false;
-
-    auto static MRTest = [&](BigInt const& base) {
-        if (base == n)
-            return;
-
-        if (composite)
-            return;
-
-        auto x = Modexp(base, d, n);
-
-        if (x == 1 || x == np)
-            return;
-
-        for (auto i = 0ull; i < r; i++) {
-            x = (x * x) % n;
-
-            if (x == np)
-                return;
+    for (auto r = 1; r < s; r++) {
+        V = sub(Mulmod64(V, V, n), Mulmod64(2, Qk, n));
+        Qk = Mulmod64(Qk, Qk, n);
+
+        if (V == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool IsPrime64(uint64_t n)
+{
+    // Deterministic for all 64-bit n: bases {2, 7, 61} suffice below 2^32 (Jaeschke), and BPSW has no
+    // counterexamples below 2^64 (Feitsma, Galway)
+    if (n < 2)
+        return false;
+
+    for (auto p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 })
+        if (n % p == 0)
+            return n == static_cast<uint64_t>(p);
+
+    if (n < 59 * 59)
+        return true;
+
+    if (n >> 32 == 0)
+        return StrongProbablePrime64(n, 2) && StrongProbablePrime64(n, 7) && StrongProbablePrime64(n, 61);
+
+    if (!StrongProbablePrime64(n, 2))
+        return false;
+
+    auto const root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    for (auto r = root > 0 ? root - 1 : 0; r <= root + 1; r++)
+        if (r * r == n)
+            return false;
+
+    return StrongLucas64(n);
+}
+
+struct TrialDivisor {
+    // Product of consecutive small primes that fits in a single group
+    uint32_t product;
+    std::vector<uint32_t> primes;
+};
+
+std::vector<TrialDivisor> TrialDivisors()
+{
+    auto divisors = std::vector<TrialDivisor> {};
+    auto const primes = SievePrimes(4096);
+
+    for (auto i = 1uz; i < primes.size(); i++) {
+        if (divisors.empty() || static_cast<uint64_t>(divisors.back().product) * primes[i] >> 32)
+            divisors.push_back({ 1, {} });
+
+        divisors.back().product *= primes[i];
+        divisors.back().primes.push_back(primes[i]);
+    }
+
+    return divisors;
+}
+
+bool StrongProbablePrime(BigInt const& n, BigInt const& base)
+{
+    auto const np = n - 1;
+    auto const r = np.trailing_zeros();
+    auto const d = np >> static_cast<int>(r);
+
+    auto x = Modexp(base, d, n);
+
+    if (x == 1 || x == np)
+        return true;
+
+    for (auto i = 1uz; i < r; i++) {
+        x = (x * x) % n;
+
+        if (x == np)
+            return true;
+    }
+
+    return false;
+}
+
+bool StrongLucas(BigInt const& n)
+{
+    // Strong Lucas probable prime test with Selfridge's parameters, see StrongLucas64
+    auto D = int64_t { 5 };
+
+    while (true) {
+        auto const m = static_cast<uint64_t>(D < 0 ? -D : D);
+        auto const jacobi = Jacobi64((n % m).to_uint64(), m);
+
+        if (jacobi == -1)
+            break;
+
+        // n is larger than |D|, so a common factor makes it composite
+        if (jacobi == 0)
+            return false;
+
+        // A square n never yields (D/n) = -1
+        if (D == 13) {
+            auto const root = Isqrt(n);
+
+            if (root * root == n)
+                return false;
         }
 
-        composite = true;
+        D = D > 0 ? -(D + 2) : -D + 2;
+    }
+
+    auto const half = [&n](BigInt value) {
+        if (value.bit_at(0))
+            value += n;
+
+        return value >> 1;
     };
 
-    [&]<std::size_t... I>(std::integer_sequence<uint64_t, I...>) { (MRTest(I), ...); }
-    (bases);
+    auto const Q = BigInt { (1 - D) / 4 } % n;
+    auto const Dn = BigInt { D } % n;
+
+    auto const np = n + 1;
+    auto const s = np.trailing_zeros();
+    auto const d = np >> static_cast<int>(s);
+
+    auto U = BigInt { 1 };
+    auto V = BigInt { 1 };
+    auto Qk = Q;
+
+    for (auto i = d.size() - 1; i-- > 0;) {
+        U = (U * V) % n;
+        V = (V * V - Qk * 2) % n;
+        Qk = (Qk * Qk) % n;
+
+        if (d.bit_at(i)) {
+            auto const u = half((U + V) % n);
+            V = half((Dn * U + V) % n);
+            U = u;
+            Qk = (Qk * Q) % n;
+        }
+    }
 
-    // Early return if bit length is less than 82; see comments above.
-    if (n.size() < 82 || composite)
-        return composite;
+    if (U.is_zero() || V.is_zero())
+        return true;
 
-    [&]<std::size_t... I>(std::integer_sequence<uint64_t, I...>) { (MRTest(I), ...); }
-    (large_bases);
+    for (auto r = 1uz; r < s; r++) {
+        V = (V * V - Qk * 2) % n;
+        Qk = (Qk * Qk) % n;
 
-    // Otherwise, we perform MR using randomized bases
-    BigInt base {};
-    for (auto i = 0; i < 10; i++) {
-        if (composite)
+        if (V.is_zero())
             return true;
+    }
+
+    return false;
+}
+}
+
+std::optional<uint64_t> Modsqrt64(uint64_t a, uint64_t p)
+{
+    // Word-sized Modsqrt for an odd prime p < 2^63, the same fast paths and Tonelli-Shanks otherwise
+    a %= p;
+
+    if (a == 0)
+        return 0;
+
+    if (Jacobi64(a, p) != 1)
+        return std::nullopt;
+
+    if (p % 4 == 3)
+        return Modexp64(a, (p + 1) / 4, p);
+
+    if (p % 8 == 5) {
+        auto const b = Modexp64(2 * a % p, (p - 5) / 8, p);
+        auto const i = Mulmod64(Mulmod64(2 * a % p, b, p), b, p);
+
+        return Mulmod64(Mulmod64(a, b, p), (i + p - 1) % p, p);
+    }
+
+    auto const s = __builtin_ctzll(p - 1);
+    auto const q = (p - 1) >> s;
+
+    auto z = uint64_t { 2 };
+
+    while (Jacobi64(z, p) != -1)
+        z++;
 
-        base.random(n.size() - 1);
+    auto m = s;
+    auto c = Modexp64(z, q, p);
+    auto t = Modexp64(a, q, p);
+    auto x = Modexp64(a, (q + 1) / 2, p);
 
-        MRTest(base);
+    while (t != 1) {
+        auto i = 0;
+
+        for (auto u = t; u != 1; u = Mulmod64(u, u, p))
+            i++;
+
+        auto b = c;
+
+        for (auto j = i + 1; j < m; j++)
+            b = Mulmod64(b, b, p);
+
+        m = i;
+        c = Mulmod64(b, b, p);
+        t = Mulmod64(t, c, p);
+        x = Mulmod64(x, b, p);
     }
 
-    return composite;
+    return x;
+}
+
+bool MillerRabin(BigInt const& n)
+{
+    /**
+     * Primality test, returns true if composite; false if probably prime
+     *
+     * Single word inputs take a deterministic native path. Larger inputs are trial divided by the primes
+     * below 4096, packed into products that fit a group so that each costs one single-word division, and
+     * the survivors go through the Baillie-PSW test: a strong probable prime test to base 2 followed by a
+     * strong Lucas test. No composite is known to pass BPSW.
+     *
+     * The test holds no state between calls, so it is reentrant and safe to call from multiple threads.
+     */
+    if (n.is_negative())
+        return true;
+
+    if (n.groups() <= 2)
+        return !IsPrime64(n.to_uint64());
+
+    if (!n.bit_at(0))
+        return true;
+
+    auto static const divisors = TrialDivisors();
+
+    for (auto const& divisor : divisors) {
+        auto const r = (n % static_cast<uint64_t>(divisor.product)).to_uint64();
+
+        for (auto p : divisor.primes)
+            if (r % p == 0)
+                return true;
+    }
+
+    return !StrongProbablePrime(n, 2) || !StrongLucas(n);
 }
 
 BigInt LenstraFactorization(BigInt const& n)
 {
     // Find a nontrival factor of n using Lenstra's factorization method
     // Works best for n semiprime, i.e. n = pq where p and q distinct primes and q of much smaller order than p
+    // The search escalates through the ECM tables until the bound exceeds half the digits of n; n is
+    // returned if no factor was found.
+    if (n <= 3 || !MillerRabin(n))
+        return n;
 
-    // FIXME: Make this interface nicer, perhaps static random to construct new BigInt directly
-    // Something like: auto a  = BigInt.random() % n;
+    if (n.bit_at(0) == 0)
+        return 2;
 
-    auto a = BigInt();
-    auto x = BigInt();
-    auto y = BigInt();
+    // log10(2) ~ 0.30103
+    auto const digits = static_cast<size_t>(n.size() * 0.30103) + 1;
 
-    a.random(n.size());
-    x.random(n.size());
-    y.random(n.size());
+    for (auto d = 10uz; d <= digits / 2 + 5; d += 5)
+        if (auto const factor = ECM(n, ECMParametersForDigits(d)))
+            return *factor;
 
-    a %= n;
-    x %= n;
-    y %= n;
-
-    // FIXME: a - b - c != a - (b + c)
-    // Currently: a - (b + c) gives the expected result for a - b - c, which is what we use below.
-    auto b = ((y * y) - ((x * x * x) + (x * a))) % n;
+    return n;
+}
 
-    auto ec = EllipticCurve(a, b, n);
-    auto P = Point(x, y, ec);
+std::vector<uint32_t> SievePrimes(uint32_t limit)
+{
+    // Sieve of Eratosthenes over the odd numbers, returns all primes <= limit
+    auto primes = std::vector<uint32_t> {};
 
-    auto j = 1;
+    if (limit < 2)
+        return primes;
 
-    while (j++) {
-        auto Q = j * P;
+    primes.push_back(2);
 
-        if (!Q.get_w()) {
-            auto d = gcd(Q.get_x() - P.get_x(), n);
+    auto composite = std::vector<bool>(limit / 2 + 1);
 
-            if (d == 1 || d == n)
-                return LenstraFactorization(n);
+    for (auto i = 3ull; i <= limit; i += 2) {
+        if (composite[i / 2])
+            continue;
 
-            return d;
-        }
+        primes.push_back(static_cast<uint32_t>(i));
 
-        P = Q;
+        for (auto j = i * i; j <= limit; j += 2 * i)
+            composite[j / 2] = true;
     }
 
-    // This is here to make the compiler happy
-    return 0;
+    return primes;
 }
@@ -2,7 +2,9 @@
 
 #include <BigInt/BigInt.h>
 #include <cstdint>
+#include <optional>
 #include <utility>
+#include <vector>
 
 BigInt gcd(BigInt const& a, BigInt const& b);
 
@@ -11,13 +13,31 @@ BigInt Totient(BigInt const& n);
 std::pair<BigInt, BigInt> BezoutCoefficients(BigInt a, BigInt b);
 
 BigInt Modinv(BigInt const& n, BigInt const& mod);
+// Word-sized Modinv for n coprime to mod < 2^63
+uint64_t Modinv64(uint64_t n, uint64_t mod);
 
 BigInt Modexp(BigInt const& base, BigInt exp, BigInt const& mod);
 
+BigInt Isqrt(BigInt const& n);
+
+// Jacobi symbol (a/n) for odd n > 0, by the binary algorithm
+int Jacobi(BigInt const& a, BigInt const& n);
+int Jacobi64(uint64_t a, uint64_t n);
+
+// Legendre symbol (a/p) for an odd prime p
+int Legendre(BigInt const& a, BigInt const& p);
+
+// Square root of a mod an odd prime p, none for non-residues. A single exponentiation for p = 3 mod 4,
+// Atkin's for p = 5 mod 8, and Tonelli-Shanks or Cipolla by the power of two in p - 1 otherwise.
+std::optional<BigInt> Modsqrt(BigInt const& a, BigInt const& p);
+std::optional<uint64_t> Modsqrt64(uint64_t a, uint64_t p);
+
 BigInt LenstraFactorization(BigInt const& n);
 
 bool MillerRabin(BigInt const& n);
 
+std::vector<uint32_t> SievePrimes(uint32_t limit);
+
 inline uint64_t Modsub(uint64_t a, uint64_t b, uint64_t mod)
 {
     // Compute (a - b (mod m)) (mod 2^64)
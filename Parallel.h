@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+inline size_t HardwareThreads(size_t requested = 0)
+{
+    // Number of worker threads to use, 0 requests one per hardware thread
+    if (requested)
+        return requested;
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+template <typename F>
+void ParallelFor(size_t count, size_t threads, F&& f)
+{
+    // Run f(i) for i in [0, count) over a pool of threads pulling indices from a shared counter,
+    // in increasing order of i. The calling thread takes part in the work.
+    auto next = std::atomic<size_t> { 0 };
+    auto const worker = [&] {
+        for (auto i = next++; i < count; i = next++)
+            f(i);
+    };
+
+    auto pool = std::vector<std::jthread> {};
+
+    for (auto i = 1uz; i < std::min(HardwareThreads(threads), count); i++)
+        pool.emplace_back(worker);
+
+    worker();
+}
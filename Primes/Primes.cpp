@@ -0,0 +1,215 @@
+#include <Modmath.h>
+#include <Parallel.h>
+#include <Primes/Primes.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+uint32_t constexpr sieve_limit = 1 << 16; // Candidates are sieved by every odd prime below this
+size_t constexpr window = 1 << 12;        // Candidates per sieved interval
+
+BigInt with_bit(BigInt value, size_t bit)
+{
+    if (!value.bit_at(bit))
+        value += BigInt { 1 } << static_cast<int>(bit);
+
+    return value;
+}
+
+bool is_prime(BigInt const& n) { return !MillerRabin(n); }
+
+BigInt Search(BigInt start, BigInt const& step, bool safe, size_t threads)
+{
+    /**
+     * Find the first c = start + i * step (i >= 0) that is prime, and for which 2c + 1 is prime if safe is set.
+     * Each window of candidates is sieved against all small primes at once, so that only the survivors pay for
+     * a modular exponentiation. The survivors are tested in parallel, in order, keeping the smallest hit.
+     * start must be odd and exceed the sieving limit, so that no candidate is itself one of the sieving primes,
+     * and step must be even. Any even step sieves correctly: an odd sieving prime coprime to step strikes one
+     * residue class of i, and one dividing step divides either every candidate or none of them.
+     */
+    auto static const primes = SievePrimes(sieve_limit);
+
+    threads = HardwareThreads(threads);
+
+    auto composite = std::vector<bool>(window);
+    auto survivors = std::vector<size_t> {};
+
+    while (true) {
+        std::fill(composite.begin(), composite.end(), false);
+
+        for (auto k = 1uz; k < primes.size(); k++) {
+            auto const p = static_cast<uint64_t>(primes[k]);
+            auto const sp = (start % p).to_uint64();
+            auto const dp = (step % p).to_uint64();
+
+            // Mark every i with start + i * step = 0 (mod p), and 2(start + i * step) + 1 = 0 (mod p) if safe
+            auto const mark = [&](uint64_t residue) {
+                if (dp == 0) {
+                    if (residue == 0)
+                        std::fill(composite.begin(), composite.end(), true);
+
+                    return;
+                }
+
+                auto const first = (p - residue) % p * Modinv64(dp, p) % p;
+
+                for (auto i = first; i < window; i += p)
+                    composite[i] = true;
+            };
+
+            mark(sp);
+
+            if (safe)
+                mark((2 * sp + 1) % p * Modinv64(2, p) % p);
+        }
+
+        survivors.clear();
+
+        for (auto i = 0uz; i < window; i++)
+            if (!composite[i])
+                survivors.push_back(i);
+
+        auto best = std::atomic<size_t> { window };
+
+        ParallelFor(survivors.size(), threads, [&](size_t k) {
+            auto const i = survivors[k];
+
+            if (i >= best)
+                return;
+
+            auto const candidate = start + step * static_cast<uint64_t>(i);
+
+            if (!is_prime(candidate) || (safe && !is_prime(candidate * 2 + 1)))
+                return;
+
+            for (auto current = best.load(); i < current && !best.compare_exchange_weak(current, i);)
+                ;
+        });
+
+        if (best < window)
+            return start + step * static_cast<uint64_t>(best.load());
+
+        start += step * static_cast<uint64_t>(window);
+    }
+}
+
+BigInt Next(BigInt const& n, bool safe, size_t threads)
+{
+    auto candidate = n < 2 ? BigInt { 2 } : n + 1;
+
+    // Below twice the sieving limit a candidate (or half of it) may be one of the sieving primes, so test directly
+    for (; candidate <= sieve_limit * 2; candidate += 1)
+        if (is_prime(candidate) && (!safe || is_prime(candidate >> 1)))
+            return candidate;
+
+    if (!candidate.bit_at(0))
+        candidate += 1;
+
+    if (!safe)
+        return Search(candidate, 2, false, threads);
+
+    // Search over q = (p - 1) / 2
+    auto q = candidate >> 1;
+
+    if (!q.bit_at(0))
+        q += 1;
+
+    return Search(q, 2, true, threads) * 2 + 1;
+}
+}
+
+BigInt NextPrime(BigInt const& n, size_t threads) { return Next(n, false, threads); }
+
+BigInt NextSafePrime(BigInt const& n, size_t threads) { return Next(n, true, threads); }
+
+BigInt RandomPrime(size_t bits, size_t threads)
+{
+    if (bits < 2)
+        throw new std::runtime_error("[Primes] A prime needs at least 2 bits");
+
+    if (bits <= 17) {
+        // Too small to sieve, search from a random point and wrap around
+        auto start = BigInt {};
+        start.random(static_cast<int>(bits));
+        start = with_bit(start, bits - 1);
+
+        auto const p = NextPrime(start - 1, threads);
+
+        return p.size() == bits ? p : NextPrime(BigInt { 1 } << static_cast<int>(bits - 1), threads);
+    }
+
+    while (true) {
+        auto start = BigInt {};
+        start.random(static_cast<int>(bits));
+        start = with_bit(with_bit(with_bit(start, bits - 1), bits - 2), 0);
+
+        auto const p = Search(start, 2, false, threads);
+
+        if (p.size() == bits)
+            return p;
+    }
+}
+
+BigInt RandomSafePrime(size_t bits, size_t threads)
+{
+    if (bits < 3)
+        throw new std::runtime_error("[Primes] A safe prime needs at least 3 bits");
+
+    if (bits <= 18) {
+        auto start = BigInt {};
+        start.random(static_cast<int>(bits));
+        start = with_bit(start, bits - 1);
+
+        auto const p = NextSafePrime(start - 1, threads);
+
+        return p.size() == bits ? p : NextSafePrime(BigInt { 1 } << static_cast<int>(bits - 1), threads);
+    }
+
+    while (true) {
+        auto start = BigInt {};
+        start.random(static_cast<int>(bits - 1));
+        start = with_bit(with_bit(with_bit(start, bits - 2), bits - 3), 0);
+
+        auto const p = Search(start, 2, true, threads) * 2 + 1;
+
+        if (p.size() == bits)
+            return p;
+    }
+}
+
+BigInt RandomStrongPrime(size_t bits, size_t threads)
+{
+    /**
+     * Gordon's algorithm
+     * 1. Pick primes s and t of about half the size of p
+     * 2. Find the first prime r in the sequence 2it + 1
+     * 3. p0 = 2 (s^(r - 2) mod r) s - 1, so that p0 = 1 (mod r) and p0 = -1 (mod s)
+     * 4. Find the first prime p in the sequence p0 + 2jrs
+     */
+    if (bits < 128)
+        throw new std::runtime_error("[Primes] Strong primes need at least 128 bits");
+
+    while (true) {
+        auto const s = RandomPrime(bits / 2 - 8, threads);
+        auto const t = RandomPrime(bits / 2 - 24, threads);
+
+        auto i = BigInt {};
+        i.random(12);
+
+        auto const r = Search(t * 2 * (i + 1) + 1, t * 2, false, threads);
+        auto const p0 = Modexp(s, r - 2, r) * s * 2 - 1;
+        auto const rs = r * s * 2;
+
+        // Start the final search at the smallest p0 + 2jrs with the top two bits set
+        auto const floor = (BigInt { 3 } << static_cast<int>(bits - 2));
+        auto j = floor > p0 ? (floor - p0 + rs - 1) / rs : BigInt {};
+
+        auto const p = Search(p0 + rs * j, rs, false, threads);
+
+        if (p.size() == bits)
+            return p;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <BigInt/BigInt.h>
+
+#include <cstddef>
+
+// Smallest probable prime p > n
+BigInt NextPrime(BigInt const& n, size_t threads = 0);
+
+// Smallest safe prime p = 2q + 1 > n, with q prime
+BigInt NextSafePrime(BigInt const& n, size_t threads = 0);
+
+// Random probable primes with exactly the given number of bits; the top two bits are set so that the product
+// of two such primes has exactly twice as many bits
+BigInt RandomPrime(size_t bits, size_t threads = 0);
+BigInt RandomSafePrime(size_t bits, size_t threads = 0);
+
+// Gordon's strong prime: p - 1 has a large prime factor r, p + 1 has a large prime factor s, and r - 1 has a
+// large prime factor t
+BigInt RandomStrongPrime(size_t bits, size_t threads = 0);